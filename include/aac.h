@@ -8,6 +8,11 @@
  * @brief Main library header file
  */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <exception>
 #include <iostream>
 #include <string>
 #include <system_error>
@@ -72,6 +77,17 @@ struct Pixel_RGBA
 
 struct Pixel_EMPTY {};
 
+/**
+ * @brief Rectangular part of an image, start indexes are inclusive and end indexes exclusive.
+ */
+struct Region
+{
+    msize_t X_start_index;
+    msize_t X_end_index;
+    msize_t Y_start_index;
+    msize_t Y_end_index;
+};
+
 /* -------------------------------------------------------------------------- */
 /*                                    ENUMS                                   */
 /* -------------------------------------------------------------------------- */
@@ -89,6 +105,28 @@ enum class error_codes {
   CHUNK_SIZE_ERROR,
 };
 
+enum class BlurKernel {
+  BOX,
+  GAUSSIAN,
+};
+
+enum class EdgeOperator {
+  SOBEL,
+  SCHARR,
+};
+
+enum class DitherKernel {
+  FLOYD_STEINBERG,
+  ATKINSON,
+  SIERRA,
+};
+
+/* -------------------------------------------------------------------------- */
+/*                                  CONSTANTS                                 */
+/* -------------------------------------------------------------------------- */
+
+extern const float DEFAULT_FONT_RATIO;
+
 enum class Pixel_Type {
   EMPTY,
   G,
@@ -158,6 +196,79 @@ public:
 
 #include "../sources/aac_matrix.tpp"
 
+/**
+ * @class StaticMatrix
+ *
+ * @brief Matrix of compile-time size stored inline (on the stack or in registers), meant for
+ *        small per-chunk scratch such as sub-cell values
+ *
+ */
+template<typename T, msize_t W, msize_t H>
+class StaticMatrix
+{
+private:
+    T _cells[H][W];
+
+public:
+    constexpr StaticMatrix();
+    constexpr StaticMatrix(const T& value);
+    static constexpr msize_t GetXSize();
+    static constexpr msize_t GetYSize();
+    constexpr T* operator[](msize_t index);
+    constexpr const T* operator[](msize_t index) const;
+    constexpr void Fill(const T& value);
+};
+
+#include "../sources/aac_static_matrix.tpp"
+
+/* -------------------------------------------------------------------------- */
+/*                              BIT MATRIX CLASS                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @class BitMatrix
+ *
+ * @brief Matrix of single bits packed into 64 bit words, every row starts with a new word
+ *
+ */
+class BitMatrix
+{
+private:
+    msize_t _size_x;
+    msize_t _size_y;
+    msize_t _words;
+    std::vector<uint64_t> _bits;
+
+public:
+    BitMatrix(msize_t size_x, msize_t size_y);
+    BitMatrix();
+    BitMatrix(Matrix<uint8_t>& matrix, uint8_t threshold);
+    msize_t GetXSize() const;
+    msize_t GetYSize() const;
+    msize_t GetWordsCount() const;
+    bool Get(msize_t x, msize_t y) const;
+    void Set(msize_t x, msize_t y, bool value);
+    uint64_t* GetRow(msize_t y);
+    const uint64_t* GetRow(msize_t y) const;
+    unsigned long Count(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index) const;
+    static void PackRow(const uint8_t* row, msize_t X_start_index, msize_t X_end_index, uint8_t threshold, uint64_t* bits);
+    static unsigned long CountRow(const uint64_t* bits, msize_t X_start_index, msize_t X_end_index);
+};
+
+/* -------------------------------------------------------------------------- */
+/*                             PARALLEL UTILITIES                             */
+/* -------------------------------------------------------------------------- */
+
+inline unsigned ResolveThreads(unsigned threads, msize_t work);
+
+template <typename F>
+unsigned ParallelBands(msize_t begin, msize_t end, unsigned threads, F&& body);
+
+template <typename F>
+unsigned ParallelTiles(msize_t tiles, unsigned threads, F&& body);
+
+#include "../sources/aac_parallel.tpp"
+
 /* -------------------------------------------------------------------------- */
 /*                                 PIXEL CLASS                                */
 /* -------------------------------------------------------------------------- */
@@ -284,8 +395,10 @@ public:
     msize_t GetSizeX() const;
     msize_t GetSizeY() const;
     Pixel_Type GetPixelType() const;
+    uint8_t GetChannels() const;
     ~Image();
     void* GetMatrix();
+    const uint8_t* GetRawRow(msize_t y);
 };
 
 /* --------------------------- GLOBAL IMAGE OPENER -------------------------- */
@@ -301,7 +414,8 @@ Image* OpenImage(std::string path);
 /**
  * @class Chunk
  *
- * @brief Representation of groups of pixels which are going to be replaced by single char
+ * @brief Representation of groups of pixels which are going to be replaced by single char.
+ *        Chunks only describe geometry, the brightness matrix is passed to the chunk converter once.
  *
  */
 class Chunk
@@ -312,20 +426,139 @@ private:
     msize_t _Y_start_index; // inclusive
     msize_t _Y_end_index; // exclusive
 
-    // pointer to external image brightness array
-    std::shared_ptr<Matrix<uint8_t>> _data;
-
 public:
     Chunk();
-    Chunk(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index, std::shared_ptr<Matrix<uint8_t>> data);
-    void SetChunk(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index, std::shared_ptr<Matrix<uint8_t>> data);
-    std::shared_ptr<Matrix<uint8_t>> GetData() const;
+    Chunk(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index);
+    void SetChunk(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index);
     msize_t GetXStart() const;
     msize_t GetXEnd() const;
     msize_t GetYStart() const;
     msize_t GetYEnd() const;
 };
 
+/* -------------------------------------------------------------------------- */
+/*                              CHUNK GRID CLASS                              */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @class ChunkGrid
+ *
+ * @brief Regular grid of equally sized chunks centered on the image, chunks are computed on demand
+ *
+ */
+class ChunkGrid
+{
+private:
+    msize_t _x_origin;
+    msize_t _y_origin;
+    msize_t _chunk_x_size;
+    msize_t _chunk_y_size;
+    msize_t _x_chunks;
+    msize_t _y_chunks;
+
+public:
+    ChunkGrid();
+    ChunkGrid(msize_t size_x, msize_t size_y, msize_t chunk_x_size, msize_t chunk_y_size);
+    msize_t GetXOrigin() const;
+    msize_t GetYOrigin() const;
+    msize_t GetChunkXSize() const;
+    msize_t GetChunkYSize() const;
+    msize_t GetXChunks() const;
+    msize_t GetYChunks() const;
+    bool IsEmpty() const;
+    Chunk GetChunk(msize_t x, msize_t y) const;
+    Region GetRegion(msize_t margin = 0) const;
+};
+
+/* -------------------------------------------------------------------------- */
+/*                              CHUNK PLAN CLASS                              */
+/* -------------------------------------------------------------------------- */
+
+class ChunkConverter;
+
+/**
+ * @class ChunkPlan
+ *
+ * @brief Precomputed chunk geometry of one image size, chunk size and font ratio,
+ *        reusable for every frame of the same dimensions
+ *
+ */
+class ChunkPlan
+{
+private:
+    msize_t _size_x;
+    msize_t _size_y;
+    size_t _chunk_size;
+    float _ratio;
+    ChunkGrid _grid;
+    std::vector<msize_t> _column_bounds;
+    std::vector<msize_t> _row_bounds;
+    std::vector<msize_t> _column_starts;
+    msize_t _x_margin;
+    msize_t _y_margin;
+
+public:
+    ChunkPlan();
+    ChunkPlan(msize_t size_x, msize_t size_y, size_t chunk_size, float ratio, const ChunkConverter* chunk_conv);
+    bool Matches(msize_t size_x, msize_t size_y, size_t chunk_size, float ratio) const;
+    const ChunkGrid& GetGrid() const;
+    const std::vector<msize_t>& GetColumnBounds() const;
+    const std::vector<msize_t>& GetRowBounds() const;
+    const std::vector<msize_t>& GetColumnStarts() const;
+    msize_t GetXCells() const;
+    msize_t GetYCells() const;
+    msize_t GetXMargin() const;
+    msize_t GetYMargin() const;
+    Region GetRegion() const;
+};
+
+/* -------------------------------------------------------------------------- */
+/*                           CHUNK STATISTICS CLASS                           */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @class ChunkStats
+ *
+ * @brief Per chunk brightness statistics (mean, variance, min, max and dominant gradient
+ *        orientation) stored as separate arrays indexed by y * x_chunks + x
+ *
+ */
+class ChunkStats
+{
+private:
+    msize_t _x_chunks;
+    msize_t _y_chunks;
+    std::vector<uint8_t> _means;
+    std::vector<float> _variances;
+    std::vector<uint8_t> _mins;
+    std::vector<uint8_t> _maxs;
+    std::vector<uint8_t> _orientations;
+
+public:
+    ChunkStats();
+    ChunkStats(const ChunkGrid& grid, Matrix<uint8_t>* brightness_matrix, unsigned threads = 0);
+    msize_t GetXChunks() const;
+    msize_t GetYChunks() const;
+    const std::vector<uint8_t>& GetMeans() const;
+    const std::vector<float>& GetVariances() const;
+    const std::vector<uint8_t>& GetMins() const;
+    const std::vector<uint8_t>& GetMaxs() const;
+    const std::vector<uint8_t>& GetOrientations() const;
+};
+
+/* -------------------------------------------------------------------------- */
+/*                          FIXED POINT WEIGHTING                             */
+/* -------------------------------------------------------------------------- */
+
+constexpr unsigned WEIGHT_SHIFT = 8;
+
+inline uint32_t FixedWeight(float weight);
+inline uint8_t WeightPixel(const uint8_t* src, Pixel_Type pixel_type, uint32_t red_weight, uint32_t green_weight, uint32_t blue_weight);
+inline void WeightRowLut(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index,
+                         uint32_t red_weight, uint32_t green_weight, uint32_t blue_weight, const uint8_t* lut, uint8_t* row);
+
+#include "../sources/brightness_converters/aac_bc_weights.tpp"
+
 /* -------------------------------------------------------------------------- */
 /*                         RIGHTNESS CONVERTER CLASSES                        */
 /* -------------------------------------------------------------------------- */
@@ -340,6 +573,12 @@ class BrightnessConverter
 {
 public:
     virtual std::shared_ptr<Matrix<uint8_t>> convert(Image* img) = 0;
+    virtual std::shared_ptr<Matrix<uint8_t>> convertRegion(Image* img, const Region& region);
+    virtual bool IsTransparent(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index) const;
+    virtual bool IsPixelLocal() const;
+    virtual bool SupportsRows() const;
+    virtual void prepareRows(Image* img, const Region& region);
+    virtual void convertRow(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index, uint8_t* row);
 };
 
 /**
@@ -358,6 +597,341 @@ public:
     BC_Simple(float red_weight, float green_weight, float blue_weight, uint8_t negate = 0);
     BC_Simple();
     std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+    std::shared_ptr<Matrix<uint8_t>> convertRegion(Image* img, const Region& region) override;
+    bool SupportsRows() const override;
+    bool IsPixelLocal() const override;
+    void convertRow(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index, uint8_t* row) override;
+};
+
+/**
+ * @class BC_Composite
+ *
+ * @brief Brightness converter compositing weighted pixel brightness over a background level
+ *
+ */
+class BC_Composite : public BrightnessConverter
+{
+private:
+    uint32_t _red_weight, _green_weight, _blue_weight;
+    const uint8_t _background;
+    const uint8_t _negate;
+    const unsigned _threads;
+
+    // bit per pixel, set when the pixel is not fully transparent
+    BitMatrix _opaque_mask;
+    // region of the last conversion, the mask is only valid inside it
+    Region _region = {0, 0, 0, 0};
+
+public:
+    BC_Composite(float red_weight, float green_weight, float blue_weight, uint8_t background = 0, uint8_t negate = 0, unsigned threads = 0);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+    std::shared_ptr<Matrix<uint8_t>> convertRegion(Image* img, const Region& region) override;
+    bool IsTransparent(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index) const override;
+    bool IsPixelLocal() const override;
+};
+
+/**
+ * @class BC_Equalize
+ *
+ * @brief Brightness converter equalizing the histogram of another converter's output
+ *
+ */
+class BC_Equalize : public BrightnessConverter
+{
+private:
+    BrightnessConverter* _source;
+    const unsigned _threads;
+
+public:
+    BC_Equalize(BrightnessConverter* source, unsigned threads = 0);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+    bool IsTransparent(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index) const override;
+};
+
+/**
+ * @class BC_CLAHE
+ *
+ * @brief Brightness converter applying contrast limited adaptive histogram equalization
+ *        to another converter's output
+ *
+ */
+class BC_CLAHE : public BrightnessConverter
+{
+private:
+    BrightnessConverter* _source;
+    msize_t _tiles_x, _tiles_y;
+    size_t _chunk_size;
+    msize_t _chunks_per_tile;
+    float _ratio;
+    const float _clip_limit;
+    const unsigned _threads;
+
+    void tileBounds(msize_t size, msize_t origin, msize_t tile_size, msize_t tiles, std::vector<msize_t>& bounds) const;
+
+public:
+    BC_CLAHE(BrightnessConverter* source, msize_t tiles_x = 8, msize_t tiles_y = 8, float clip_limit = 2.0, unsigned threads = 0);
+    void AlignToChunks(size_t chunk_size, msize_t chunks_per_tile = 1, float ratio = DEFAULT_FONT_RATIO);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+};
+
+/**
+ * @class BC_Edges
+ *
+ * @brief Brightness converter replacing another converter's output with its gradient magnitude
+ *
+ */
+class BC_Edges : public BrightnessConverter
+{
+private:
+    BrightnessConverter* _source;
+    const EdgeOperator _operator;
+    const bool _directions;
+    const unsigned _threads;
+    std::shared_ptr<Matrix<uint8_t>> _direction_matrix;
+
+public:
+    BC_Edges(BrightnessConverter* source, EdgeOperator op = EdgeOperator::SOBEL, bool directions = false, unsigned threads = 0);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+    std::shared_ptr<Matrix<uint8_t>> convertRegion(Image* img, const Region& region) override;
+    std::shared_ptr<Matrix<uint8_t>> GetDirections() const;
+};
+
+/**
+ * @class BC_Dither
+ *
+ * @brief Brightness converter quantizing another converter's output with error diffusion
+ *
+ */
+class BC_Dither : public BrightnessConverter
+{
+private:
+    BrightnessConverter* _source;
+    const DitherKernel _kernel;
+    const bool _serpentine;
+    const uint8_t _levels;
+    const unsigned _threads;
+
+public:
+    BC_Dither(BrightnessConverter* source, DitherKernel kernel = DitherKernel::FLOYD_STEINBERG, bool serpentine = false, uint8_t levels = 2, unsigned threads = 0);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+};
+
+/**
+ * @class BC_Blur
+ *
+ * @brief Brightness converter blurring another converter's output with a separable kernel
+ *
+ */
+class BC_Blur : public BrightnessConverter
+{
+private:
+    BrightnessConverter* _source;
+    const BlurKernel _kernel;
+    const msize_t _radius;
+    const unsigned _threads;
+    std::vector<uint32_t> _weights;
+
+public:
+    BC_Blur(BrightnessConverter* source, BlurKernel kernel = BlurKernel::GAUSSIAN, msize_t radius = 1, unsigned threads = 0);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+    std::shared_ptr<Matrix<uint8_t>> convertRegion(Image* img, const Region& region) override;
+};
+
+/**
+ * @class BC_Sharpen
+ *
+ * @brief Brightness converter sharpening another converter's output with an unsharp mask
+ *
+ */
+class BC_Sharpen : public BrightnessConverter
+{
+private:
+    BrightnessConverter* _source;
+    int32_t _amount;
+    const BlurKernel _kernel;
+    const msize_t _radius;
+    const unsigned _threads;
+    std::vector<uint32_t> _weights;
+
+public:
+    BC_Sharpen(BrightnessConverter* source, float amount = 1, BlurKernel kernel = BlurKernel::GAUSSIAN, msize_t radius = 1, unsigned threads = 0);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+    std::shared_ptr<Matrix<uint8_t>> convertRegion(Image* img, const Region& region) override;
+};
+
+/**
+ * @class BC_AutoLevels
+ *
+ * @brief Brightness converter stretching weighted brightness between percentiles of a sampled histogram
+ *
+ */
+class BC_AutoLevels : public BrightnessConverter
+{
+private:
+    uint32_t _red_weight, _green_weight, _blue_weight;
+    const float _low_percentile, _high_percentile;
+    const msize_t _stride;
+    uint8_t _lut[256];
+
+public:
+    BC_AutoLevels(float red_weight, float green_weight, float blue_weight, float low_percentile = 1, float high_percentile = 99, msize_t stride = 4);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+    std::shared_ptr<Matrix<uint8_t>> convertRegion(Image* img, const Region& region) override;
+    bool SupportsRows() const override;
+    void prepareRows(Image* img, const Region& region) override;
+    void convertRow(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index, uint8_t* row) override;
+};
+
+/* -------------------------------------------------------------------------- */
+/*                               PIPELINE STAGES                              */
+/* -------------------------------------------------------------------------- */
+
+namespace Stage {
+
+/**
+ * @brief Pixel stage computing brightness as the weighted channel sum (weights have the BC_Simple meaning).
+ */
+struct Weights
+{
+    float red_weight, green_weight, blue_weight;
+
+    Weights(float red_weight = 1, float green_weight = 1, float blue_weight = 1);
+};
+
+/**
+ * @brief Value stage applying a gamma curve.
+ */
+struct Gamma
+{
+    float gamma;
+
+    Gamma(float gamma = 1);
+    uint8_t Apply(uint8_t value) const;
+};
+
+/**
+ * @brief Value stage negating the brightness.
+ */
+struct Negate
+{
+    uint8_t Apply(uint8_t value) const;
+};
+
+/**
+ * @brief Value stage scaling the brightness distance from a pivot level.
+ */
+struct Contrast
+{
+    float factor, pivot;
+
+    Contrast(float factor = 1, float pivot = 127.5);
+    uint8_t Apply(uint8_t value) const;
+};
+
+/**
+ * @brief Value stage clamping the brightness into a range.
+ */
+struct Clamp
+{
+    uint8_t low, high;
+
+    Clamp(uint8_t low = 0, uint8_t high = 255);
+    uint8_t Apply(uint8_t value) const;
+};
+
+/**
+ * @brief Value stage adding a saturating brightness offset.
+ */
+struct Brightness
+{
+    int offset;
+
+    Brightness(int offset = 0);
+    uint8_t Apply(uint8_t value) const;
+};
+
+} // namespace Stage
+
+/**
+ * @class BC_Adjust
+ *
+ * @brief Brightness converter applying a runtime chain of value adjustments, composed into
+ *        a single lookup table, on top of channel weighting
+ *
+ */
+class BC_Adjust : public BrightnessConverter
+{
+private:
+    uint32_t _red_weight, _green_weight, _blue_weight;
+    uint8_t _lut[256];
+
+    template<typename ValueStage>
+    BC_Adjust& compose(const ValueStage& stage);
+
+public:
+    BC_Adjust(float red_weight = 1, float green_weight = 1, float blue_weight = 1);
+    BC_Adjust& AddGamma(float gamma);
+    BC_Adjust& AddContrast(float factor, float pivot = 127.5);
+    BC_Adjust& AddBrightness(int offset);
+    BC_Adjust& AddNegate();
+    BC_Adjust& AddClamp(uint8_t low, uint8_t high);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+    std::shared_ptr<Matrix<uint8_t>> convertRegion(Image* img, const Region& region) override;
+    bool SupportsRows() const override;
+    bool IsPixelLocal() const override;
+    void convertRow(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index, uint8_t* row) override;
+};
+
+/**
+ * @class BC_Pipeline
+ *
+ * @brief Brightness converter chaining a pixel stage and value stages fused into a single pass.
+ *        Value stages are collapsed into one lookup table at construction.
+ *
+ */
+template<typename PixelStage, typename... ValueStages>
+class BC_Pipeline : public BrightnessConverter
+{
+private:
+    uint32_t _red_weight, _green_weight, _blue_weight;
+    uint8_t _lut[256];
+
+    template<msize_t channels>
+    void weightRow(const uint8_t* src, msize_t X_start_index, msize_t X_end_index, uint8_t* row) const;
+
+public:
+    BC_Pipeline(const PixelStage& pixel_stage, const ValueStages&... value_stages);
+    std::shared_ptr<Matrix<uint8_t>> convert(Image* img) override;
+    std::shared_ptr<Matrix<uint8_t>> convertRegion(Image* img, const Region& region) override;
+    bool SupportsRows() const override;
+    bool IsPixelLocal() const override;
+    void convertRow(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index, uint8_t* row) override;
+};
+
+#include "../sources/brightness_converters/aac_bc_pipeline.tpp"
+
+/* -------------------------------------------------------------------------- */
+/*                          BRIGHTNESS PYRAMID CLASS                          */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @class BrightnessPyramid
+ *
+ * @brief Brightness matrix with successively 2x2 averaged levels, reused for conversions
+ *        at several chunk sizes
+ *
+ */
+class BrightnessPyramid
+{
+private:
+    std::vector<std::shared_ptr<Matrix<uint8_t>>> _levels;
+
+public:
+    BrightnessPyramid(BrightnessConverter* brightness_conv, Image* img);
+    msize_t GetLevelsCount() const;
+    std::shared_ptr<Matrix<uint8_t>> GetLevel(msize_t level) const;
+    msize_t GetSizeX() const;
+    msize_t GetSizeY() const;
 };
 
 /* -------------------------------------------------------------------------- */
@@ -372,8 +946,18 @@ public:
  */
 class ChunkConverter
 {
+protected:
+    unsigned _threads;
+
 public:
-    virtual std::string convert(Matrix<Chunk>* chunks) = 0;
+    ChunkConverter();
+    void SetThreads(unsigned threads);
+    virtual std::string convert(const ChunkPlan& plan, Matrix<uint8_t>* brightness_matrix, const BitMatrix* transparent_chunks = NULL);
+    virtual void sumChunks(const ChunkPlan& plan, Matrix<uint8_t>* brightness_matrix, const BitMatrix* transparent_chunks, Matrix<unsigned long>& sums);
+    virtual void subcellBounds(msize_t chunk_x_size, msize_t chunk_y_size, std::vector<msize_t>& column_bounds, std::vector<msize_t>& row_bounds) const;
+    virtual msize_t chunkMargin() const;
+    virtual bool pixelThreshold(uint8_t& threshold) const;
+    virtual void convertSums(Matrix<unsigned long>* sums, const std::vector<msize_t>& column_bounds, const std::vector<msize_t>& row_bounds, std::string& art) = 0;
 };
 
 /**
@@ -389,28 +973,199 @@ private:
 
 public:
     CC_Simple(std::string alphabet);
-    std::string convert(Matrix<Chunk>* chunks) override;
+    void convertSums(Matrix<unsigned long>* sums, const std::vector<msize_t>& column_bounds, const std::vector<msize_t>& row_bounds, std::string& art) override;
+
+};
+
+/* -------------------------------------------------------------------------- */
+/*                              SUB-CELL GLYPHS                               */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @brief Glyph sets of the CC_SubCells converter. A set gives the shape of the sub-cell grid,
+ *        the ranks in which pixels that do not divide evenly are given to the sub-cell columns
+ *        and rows (rank 0 first), and the code point of every sub-cell mask, where bit
+ *        row * COLUMNS + column is set for a raised sub-cell.
+ */
+namespace Glyphs {
+
+/**
+ * @brief UTF-8 encoding of a single glyph.
+ */
+struct Utf8
+{
+    char bytes[4];
+    uint8_t length;
+};
+
+constexpr uint32_t SextantGlyph(unsigned mask);
+constexpr uint32_t BrailleGlyph(unsigned mask);
+
+template <size_t masks>
+constexpr std::array<uint32_t, masks> MakeTable(uint32_t (*glyph)(unsigned));
+
+template <size_t masks>
+constexpr std::array<Utf8, masks> Encode(const std::array<uint32_t, masks>& table);
+
+#include "../sources/chunk_converters/aac_glyphs.tpp"
+
+/**
+ * @brief Unicode quadrant blocks, 2x2 sub-cells.
+ */
+struct Quadrants
+{
+    static constexpr msize_t COLUMNS = 2;
+    static constexpr msize_t ROWS = 2;
+    static constexpr msize_t COLUMN_RANKS[COLUMNS] = {0, 1};
+    static constexpr msize_t ROW_RANKS[ROWS] = {0, 1};
+    static constexpr std::array<uint32_t, 16> TABLE = {0x0020, 0x2598, 0x259D, 0x2580, 0x2596, 0x258C, 0x259E, 0x259B,
+                                                       0x2597, 0x259A, 0x2590, 0x259C, 0x2584, 0x2599, 0x259F, 0x2588};
+};
+
+/**
+ * @brief Unicode sextants (with the half and full blocks they lack), 2x3 sub-cells.
+ */
+struct Sextants
+{
+    static constexpr msize_t COLUMNS = 2;
+    static constexpr msize_t ROWS = 3;
+    static constexpr msize_t COLUMN_RANKS[COLUMNS] = {0, 1};
+    static constexpr msize_t ROW_RANKS[ROWS] = {1, 0, 2};
+    static constexpr std::array<uint32_t, 64> TABLE = MakeTable<64>(SextantGlyph);
+};
+
+/**
+ * @brief Braille patterns, 2x4 sub-cells.
+ */
+struct Braille
+{
+    static constexpr msize_t COLUMNS = 2;
+    static constexpr msize_t ROWS = 4;
+    static constexpr msize_t COLUMN_RANKS[COLUMNS] = {0, 1};
+    static constexpr msize_t ROW_RANKS[ROWS] = {2, 0, 1, 3};
+    static constexpr std::array<uint32_t, 256> TABLE = MakeTable<256>(BrailleGlyph);
+};
+
+} // namespace Glyphs
+
+uint8_t OtsuThreshold(const unsigned long* histogram);
+
+/**
+ * @class CC_SubCells
+ *
+ * @brief Converter raising the sub-cells of a glyph grid brighter than the break point and
+ *        printing the glyph of the raised sub-cells
+ *
+ * @tparam GlyphSet The glyph set (see the Glyphs namespace).
+ */
+template <typename GlyphSet>
+class CC_SubCells : public ChunkConverter
+{
+private:
+    static constexpr msize_t _cells = GlyphSet::COLUMNS * GlyphSet::ROWS;
+    static_assert(_cells <= 8, "the sub-cell mask must fit a byte");
+    static constexpr std::array<Glyphs::Utf8, (1u << _cells)> _glyphs = Glyphs::Encode(GlyphSet::TABLE);
+
+    const bool _auto_threshold;
+    uint8_t _threshold;
+    std::vector<uint8_t> _masks;
+    std::vector<msize_t> _line_starts;
+
+public:
+    CC_SubCells(uint8_t break_point_brightness);
+    CC_SubCells();
+    uint8_t GetThreshold() const;
+    void subcellBounds(msize_t chunk_x_size, msize_t chunk_y_size, std::vector<msize_t>& column_bounds, std::vector<msize_t>& row_bounds) const override;
+    void convertSums(Matrix<unsigned long>* sums, const std::vector<msize_t>& column_bounds, const std::vector<msize_t>& row_bounds, std::string& art) override;
 
 };
 
+#include "../sources/chunk_converters/aac_cc_sub_cells.tpp"
+
+typedef CC_SubCells<Glyphs::Quadrants> CC_Quadrants;
+typedef CC_SubCells<Glyphs::Sextants> CC_Sextants;
+
 /**
  * @class CC_Braile
  *
  * @brief Converter that uses Braile characters (not soo ascii anymore)
  *
  */
-class CC_Braile : public ChunkConverter
+class CC_Braile : public CC_SubCells<Glyphs::Braille>
+{
+public:
+    CC_Braile(uint8_t break_point_brightness);
+    CC_Braile();
+    msize_t chunkMargin() const override;
+
+};
+
+/**
+ * @class CC_BraileBits
+ *
+ * @brief Braille converter raising dots covered mostly by pixels brighter than the break point,
+ *        working on bit packed pixel decisions
+ *
+ */
+class CC_BraileBits : public CC_Braile
 {
 private:
-    static wchar_t get_braile_char(uint8_t char_val);
-    const uint8_t _bk_brightness;
+    const uint8_t _pixel_threshold;
 
 public:
-    CC_Braile(uint8_t break_point_brightness);
-    std::string convert(Matrix<Chunk>* chunks) override;
+    CC_BraileBits(uint8_t break_point_brightness);
+    bool pixelThreshold(uint8_t& threshold) const override;
 
 };
 
+/* -------------------------------------------------------------------------- */
+/*                           CONVERSION PLAN CLASS                            */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * @class ConversionPlan
+ *
+ * @brief Conversion of a stream of equally sized frames, owns the chunk geometry and every
+ *        scratch buffer so running it on a frame does no setup work
+ *
+ */
+class ConversionPlan
+{
+private:
+    BrightnessConverter* _brightness_conv;
+    ChunkConverter* _chunk_conv;
+    msize_t _size_x;
+    msize_t _size_y;
+    Pixel_Type _pixel_type;
+    size_t _chunk_size;
+    float _ratio;
+    bool _fusion;
+    ChunkPlan _plan;
+    Matrix<unsigned long> _sums;
+    std::vector<uint8_t> _row;
+    std::vector<uint64_t> _bits;
+    BitMatrix _transparent_chunks;
+    uint8_t _threshold;
+    bool _binary;
+    bool _tracking;
+    bool _hashed;
+    std::vector<uint64_t> _hashes;
+    std::vector<uint64_t> _row_hashes;
+    BitMatrix _changed_chunks;
+
+    void sumRows(Image* frame);
+    void sumMatrix(Image* frame);
+
+public:
+    ConversionPlan(msize_t size_x, msize_t size_y, Pixel_Type pixel_type, size_t chunk_size, BrightnessConverter* brightness_conv,
+                   ChunkConverter* chunk_conv, float ratio = DEFAULT_FONT_RATIO, bool fusion = true);
+    bool Matches(msize_t size_x, msize_t size_y, Pixel_Type pixel_type, size_t chunk_size, float ratio, bool fusion) const;
+    const ChunkPlan& GetChunkPlan() const;
+    void SetChangeTracking(bool tracking);
+    const BitMatrix& GetChangedChunks() const;
+    void Run(Image* frame, std::string& art);
+};
+
 /* -------------------------------------------------------------------------- */
 /*                               CONVERTER CLASS                              */
 /* -------------------------------------------------------------------------- */
@@ -418,22 +1173,32 @@ public:
 /**
  * @class Converter
  *
- * @brief Creates main converter combining all other steps to create art
+ * @brief Creates main converter combining all other steps to create art. The converter caches the
+ *        plan of its last conversion, so it is not thread safe: concurrent CreateArt calls need
+ *        a Converter (and converter objects) per thread.
  *
  */
 class Converter
 {
 private:
 
-    static const float _ratio;
     BrightnessConverter* _brightness_conv;
     ChunkConverter* _chunk_conv;
-    
-    Matrix<Chunk>* generateChunks(Image* img, size_t chunk_size, std::shared_ptr<Matrix<uint8_t>> brightness_matrix);
+    float _ratio;
+    bool _fusion;
+    ChunkPlan _plan;
+    std::shared_ptr<ConversionPlan> _conversion;
 
 public:
-    Converter(BrightnessConverter* brightness_conv, ChunkConverter* chunk_conv);
+    Converter(BrightnessConverter* brightness_conv, ChunkConverter* chunk_conv, float ratio = DEFAULT_FONT_RATIO);
+    float GetRatio() const;
+    void SetRatio(float ratio);
+    void SetFusion(bool fusion);
+    const ChunkPlan& GetPlan(msize_t size_x, msize_t size_y, size_t chunk_size);
     std::string CreateArt(Image* img, size_t chunk_size);
+    std::string CreateArt(Image* img, size_t columns, size_t rows);
+    std::string CreateArt(BrightnessPyramid* pyramid, size_t chunk_size);
+    ChunkStats CreateStats(Image* img, size_t chunk_size);
 };
 
 } // namespace AAC
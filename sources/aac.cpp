@@ -49,9 +49,9 @@ Image *OpenImage(std::string path) {
 /* ----------------------- FONT WIDTH TO HEIGHT RATIO ----------------------- */
 
 /**
- * @brief Ratio of font width to height used for proper chunks division
+ * @brief Default ratio of font width to height used for proper chunks division
  * 
  */
-const float Converter::_ratio = 0.45;
+const float DEFAULT_FONT_RATIO = 0.45;
 
 } // namespace AAC
@@ -0,0 +1,236 @@
+#include <aac.h>
+
+/**
+ * @file aac_bit_matrix.cpp
+ * @brief Contains the implementation of the BitMatrix class.
+ */
+
+using namespace AAC;
+
+#define BIT_MATRIX_WORD_BITS 64
+
+/**
+ * @brief Counts set bits of a word.
+ *
+ * @param word The word.
+ * @return The number of set bits.
+ */
+static inline unsigned popcount64(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned)__builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (unsigned)((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/**
+ * @brief Gets the mask of bits first ... last of a single word.
+ *
+ * @param first First bit (inclusive).
+ * @param last Last bit (inclusive).
+ * @return The mask.
+ */
+static inline uint64_t rangeMask(msize_t first, msize_t last) {
+    return (~0ull << first) & (~0ull >> (BIT_MATRIX_WORD_BITS - 1 - last));
+}
+
+/**
+ * @brief Constructs a BitMatrix with all bits cleared.
+ *
+ * @param size_x The size in the x-axis.
+ * @param size_y The size in the y-axis.
+ */
+BitMatrix::BitMatrix(msize_t size_x, msize_t size_y) :
+    _size_x(size_x), _size_y(size_y), _words((size_x + BIT_MATRIX_WORD_BITS - 1) / BIT_MATRIX_WORD_BITS), _bits(_words * size_y, 0) {}
+
+/**
+ * @brief Constructs a BitMatrix with size (0, 0).
+ */
+BitMatrix::BitMatrix() : BitMatrix(0, 0) {}
+
+/**
+ * @brief Constructs a BitMatrix by comparing every value of the matrix with the threshold.
+ *
+ * @param matrix The source matrix.
+ * @param threshold Values above the threshold give set bits.
+ */
+BitMatrix::BitMatrix(Matrix<uint8_t>& matrix, uint8_t threshold) : BitMatrix(matrix.GetXSize(), matrix.GetYSize()) {
+    for (msize_t y = 0; y < _size_y; y++) {
+        PackRow(matrix[y].data(), 0, _size_x, threshold, GetRow(y));
+    }
+}
+
+/**
+ * @brief Gets the size in the x-axis.
+ *
+ * @return The size in the x-axis.
+ */
+msize_t BitMatrix::GetXSize() const {
+    return _size_x;
+}
+
+/**
+ * @brief Gets the size in the y-axis.
+ *
+ * @return The size in the y-axis.
+ */
+msize_t BitMatrix::GetYSize() const {
+    return _size_y;
+}
+
+/**
+ * @brief Gets the number of words of every row.
+ *
+ * @return The number of words per row.
+ */
+msize_t BitMatrix::GetWordsCount() const {
+    return _words;
+}
+
+/**
+ * @brief Gets a single bit.
+ *
+ * @param x The x coordinate.
+ * @param y The y coordinate.
+ * @return The bit value.
+ *
+ * @throws error_code An exception is thrown if the coordinates are out of bounds.
+ */
+bool BitMatrix::Get(msize_t x, msize_t y) const {
+    if (x >= _size_x || y >= _size_y) {
+        throw AACException(error_codes::MATRIX_INDEX_OUT_OF_BOUNDS);
+    }
+    return (_bits[y * _words + x / BIT_MATRIX_WORD_BITS] >> (x % BIT_MATRIX_WORD_BITS)) & 1;
+}
+
+/**
+ * @brief Sets a single bit.
+ *
+ * @param x The x coordinate.
+ * @param y The y coordinate.
+ * @param value The bit value.
+ *
+ * @throws error_code An exception is thrown if the coordinates are out of bounds.
+ */
+void BitMatrix::Set(msize_t x, msize_t y, bool value) {
+    if (x >= _size_x || y >= _size_y) {
+        throw AACException(error_codes::MATRIX_INDEX_OUT_OF_BOUNDS);
+    }
+    uint64_t& word = _bits[y * _words + x / BIT_MATRIX_WORD_BITS];
+    uint64_t bit = 1ull << (x % BIT_MATRIX_WORD_BITS);
+    word = value ? (word | bit) : (word & ~bit);
+}
+
+/**
+ * @brief Gets the words of a row, bit x % 64 of word x / 64 holds column x.
+ *
+ * @param y The row index.
+ * @return Pointer to the first word of the row.
+ */
+uint64_t* BitMatrix::GetRow(msize_t y) {
+    return &_bits[y * _words];
+}
+
+/**
+ * @brief Gets the words of a row, bit x % 64 of word x / 64 holds column x.
+ *
+ * @param y The row index.
+ * @return Pointer to the first word of the row.
+ */
+const uint64_t* BitMatrix::GetRow(msize_t y) const {
+    return &_bits[y * _words];
+}
+
+/**
+ * @brief Counts set bits of a region.
+ *
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param Y_start_index The starting index of the Y-axis (inclusive).
+ * @param Y_end_index The ending index of the Y-axis (exclusive).
+ * @return The number of set bits.
+ *
+ * @throws error_code An exception is thrown if the region is out of bounds.
+ */
+unsigned long BitMatrix::Count(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index) const {
+    if (X_end_index > _size_x || Y_end_index > _size_y) {
+        throw AACException(error_codes::MATRIX_INDEX_OUT_OF_BOUNDS);
+    }
+
+    unsigned long count = 0;
+    for (msize_t y = Y_start_index; y < Y_end_index; y++) {
+        count += CountRow(GetRow(y), X_start_index, X_end_index);
+    }
+    return count;
+}
+
+/**
+ * @brief Compares a part of a row with the threshold and packs the results into words. Words
+ *        touched by the range are overwritten, bits outside the range are cleared.
+ *
+ * @param row The values, indexed with x coordinates.
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param threshold Values above the threshold give set bits.
+ * @param bits The packed row, bit x % 64 of word x / 64 holds column x.
+ */
+void BitMatrix::PackRow(const uint8_t* row, msize_t X_start_index, msize_t X_end_index, uint8_t threshold, uint64_t* bits) {
+    if (X_start_index >= X_end_index) {
+        return;
+    }
+
+    for (msize_t word = X_start_index / BIT_MATRIX_WORD_BITS; word <= (X_end_index - 1) / BIT_MATRIX_WORD_BITS; word++) {
+        msize_t base = word * BIT_MATRIX_WORD_BITS;
+        msize_t first = std::max(X_start_index, base) - base;
+        msize_t last = std::min(X_end_index, base + BIT_MATRIX_WORD_BITS) - base;
+        const uint8_t* values = row + base;
+        uint64_t packed = 0;
+
+        // whole words have a constant trip count the compiler can vectorize
+        if (0 == first && BIT_MATRIX_WORD_BITS == last) {
+            for (unsigned bit = 0; bit < BIT_MATRIX_WORD_BITS; bit++) {
+                packed |= (uint64_t)(values[bit] > threshold) << bit;
+            }
+        }
+        else {
+            for (msize_t bit = first; bit < last; bit++) {
+                packed |= (uint64_t)(values[bit] > threshold) << bit;
+            }
+        }
+
+        bits[word] = packed;
+    }
+}
+
+/**
+ * @brief Counts set bits of a part of a packed row.
+ *
+ * @param bits The packed row.
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @return The number of set bits.
+ */
+unsigned long BitMatrix::CountRow(const uint64_t* bits, msize_t X_start_index, msize_t X_end_index) {
+    if (X_start_index >= X_end_index) {
+        return 0;
+    }
+
+    msize_t first_word = X_start_index / BIT_MATRIX_WORD_BITS;
+    msize_t last_word = (X_end_index - 1) / BIT_MATRIX_WORD_BITS;
+    msize_t first_bit = X_start_index % BIT_MATRIX_WORD_BITS;
+    msize_t last_bit = (X_end_index - 1) % BIT_MATRIX_WORD_BITS;
+
+    if (first_word == last_word) {
+        return popcount64(bits[first_word] & rangeMask(first_bit, last_bit));
+    }
+
+    unsigned long count = popcount64(bits[first_word] & rangeMask(first_bit, BIT_MATRIX_WORD_BITS - 1)) +
+                          popcount64(bits[last_word] & rangeMask(0, last_bit));
+    for (msize_t word = first_word + 1; word < last_word; word++) {
+        count += popcount64(bits[word]);
+    }
+    return count;
+}
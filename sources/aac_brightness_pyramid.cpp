@@ -0,0 +1,90 @@
+#include <aac.h>
+
+/**
+ * @file aac_brightness_pyramid.cpp
+ * @brief Contains the implementation of the BrightnessPyramid class.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Constructs a BrightnessPyramid from the brightness of the given image. Every level averages
+ *        2x2 blocks of the previous one (an odd last row or column is dropped) until a side would
+ *        become smaller than a single pixel.
+ *
+ * @param brightness_conv The brightness converter producing level 0.
+ * @param img The image to convert.
+ *
+ * @throws error_code An exception is thrown if the converter or image is null.
+ */
+BrightnessPyramid::BrightnessPyramid(BrightnessConverter* brightness_conv, Image* img) {
+
+    if (NULL == brightness_conv || NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _levels.push_back(brightness_conv->convert(img));
+
+    while (_levels.back()->GetXSize() >= 2 && _levels.back()->GetYSize() >= 2) {
+        Matrix<uint8_t>& previous = *_levels.back();
+        msize_t size_x = previous.GetXSize() / 2;
+        msize_t size_y = previous.GetYSize() / 2;
+        std::shared_ptr<Matrix<uint8_t>> level(new Matrix<uint8_t>(size_x, size_y));
+
+        for (msize_t y = 0; y < size_y; y++) {
+            const uint8_t* upper = previous[2 * y].data();
+            const uint8_t* lower = previous[2 * y + 1].data();
+            uint8_t* row = (*level)[y].data();
+
+            for (msize_t x = 0; x < size_x; x++) {
+                row[x] = (uint8_t)((upper[2 * x] + upper[2 * x + 1] + lower[2 * x] + lower[2 * x + 1] + 2) >> 2);
+            }
+        }
+
+        _levels.push_back(level);
+    }
+}
+
+/**
+ * @brief Gets the number of levels, level 0 being the full resolution brightness.
+ *
+ * @return The number of levels.
+ */
+msize_t BrightnessPyramid::GetLevelsCount() const {
+    return _levels.size();
+}
+
+/**
+ * @brief Gets the brightness matrix of the given level.
+ *
+ * @param level The level index.
+ * @return A shared pointer to the level matrix.
+ *
+ * @throws error_code An exception is thrown if the level does not exist.
+ */
+std::shared_ptr<Matrix<uint8_t>> BrightnessPyramid::GetLevel(msize_t level) const {
+
+    if (level >= _levels.size()) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    return _levels[level];
+}
+
+/**
+ * @brief Gets the full resolution size in the x-axis.
+ *
+ * @return The size in the x-axis.
+ */
+msize_t BrightnessPyramid::GetSizeX() const {
+    return _levels[0]->GetXSize();
+}
+
+/**
+ * @brief Gets the full resolution size in the y-axis.
+ *
+ * @return The size in the y-axis.
+ */
+msize_t BrightnessPyramid::GetSizeY() const {
+    return _levels[0]->GetYSize();
+}
@@ -1,5 +1,7 @@
 #include <aac.h>
 
+#include <type_traits>
+
 /**
  * @file aac_chunk.cpp
  * @brief Contains the implementation of the Chunk class.
@@ -7,6 +9,9 @@
 
 using namespace AAC;
 
+// chunks are plain geometry, copied without touching any reference counts
+static_assert(std::is_trivially_copyable<Chunk>::value, "Chunk must be trivially copyable");
+
 /**
  * @brief Constructs a Chunk object with the specified parameters.
  *
@@ -14,15 +19,14 @@ using namespace AAC;
  * @param X_end_index The ending index of the X-axis.
  * @param Y_start_index The starting index of the Y-axis.
  * @param Y_end_index The ending index of the Y-axis.
- * @param data The shared pointer to the data matrix.
  */
-Chunk::Chunk(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index, std::shared_ptr<Matrix<uint8_t>> data) :
-    _X_start_index(X_start_index), _X_end_index(X_end_index), _Y_start_index(Y_start_index), _Y_end_index(Y_end_index), _data(data) {}
+Chunk::Chunk(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index) :
+    _X_start_index(X_start_index), _X_end_index(X_end_index), _Y_start_index(Y_start_index), _Y_end_index(Y_end_index) {}
 
 /**
  * @brief Constructs a Chunk object with default values.
  */
-Chunk::Chunk() : Chunk(0, 0, 0, 0, NULL) {}
+Chunk::Chunk() : Chunk(0, 0, 0, 0) {}
 
 /**
  * @brief Sets the parameters of the Chunk object.
@@ -31,23 +35,12 @@ Chunk::Chunk() : Chunk(0, 0, 0, 0, NULL) {}
  * @param X_end_index The ending index of the X-axis.
  * @param Y_start_index The starting index of the Y-axis.
  * @param Y_end_index The ending index of the Y-axis.
- * @param data The shared pointer to the data matrix.
  */
-void Chunk::SetChunk(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index, std::shared_ptr<Matrix<uint8_t>> data) {
+void Chunk::SetChunk(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index) {
     _X_start_index = X_start_index;
     _X_end_index = X_end_index;
     _Y_start_index = Y_start_index;
     _Y_end_index = Y_end_index;
-    _data = data;
-}
-
-/**
- * @brief Gets the shared pointer to the data matrix of the Chunk.
- *
- * @return The shared pointer to the data matrix.
- */
-std::shared_ptr<Matrix<uint8_t>> Chunk::GetData() const {
-    return _data;
 }
 
 /**
@@ -0,0 +1,128 @@
+#include <aac.h>
+
+/**
+ * @file aac_chunk_grid.cpp
+ * @brief Contains the implementation of the ChunkGrid class.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Constructs an empty ChunkGrid.
+ */
+ChunkGrid::ChunkGrid() :
+    _x_origin(0), _y_origin(0), _chunk_x_size(0), _chunk_y_size(0), _x_chunks(0), _y_chunks(0) {}
+
+/**
+ * @brief Constructs a ChunkGrid covering as much of the image as whole chunks can. The pixels
+ *        left over are split between both sides (the extra one goes to the end).
+ *
+ * @param size_x The image size in the x-axis.
+ * @param size_y The image size in the y-axis.
+ * @param chunk_x_size The chunk size in the x-axis.
+ * @param chunk_y_size The chunk size in the y-axis.
+ *
+ * @throws error_code An exception is thrown if any chunk size is 0.
+ */
+ChunkGrid::ChunkGrid(msize_t size_x, msize_t size_y, msize_t chunk_x_size, msize_t chunk_y_size) :
+    _chunk_x_size(chunk_x_size), _chunk_y_size(chunk_y_size) {
+
+    if (0 == chunk_x_size || 0 == chunk_y_size) {
+        throw AACException(error_codes::CHUNK_SIZE_ERROR);
+    }
+
+    _x_chunks = size_x / chunk_x_size;
+    _x_origin = (size_x % chunk_x_size) / 2;
+    _y_chunks = size_y / chunk_y_size;
+    _y_origin = (size_y % chunk_y_size) / 2;
+}
+
+/**
+ * @brief Gets the x coordinate of the first chunk.
+ *
+ * @return The number of columns cut on the left.
+ */
+msize_t ChunkGrid::GetXOrigin() const {
+    return _x_origin;
+}
+
+/**
+ * @brief Gets the y coordinate of the first chunk.
+ *
+ * @return The number of rows cut on the top.
+ */
+msize_t ChunkGrid::GetYOrigin() const {
+    return _y_origin;
+}
+
+/**
+ * @brief Gets the chunk size in the x-axis.
+ *
+ * @return The chunk width.
+ */
+msize_t ChunkGrid::GetChunkXSize() const {
+    return _chunk_x_size;
+}
+
+/**
+ * @brief Gets the chunk size in the y-axis.
+ *
+ * @return The chunk height.
+ */
+msize_t ChunkGrid::GetChunkYSize() const {
+    return _chunk_y_size;
+}
+
+/**
+ * @brief Gets the number of chunk columns.
+ *
+ * @return The number of chunks in the x-axis.
+ */
+msize_t ChunkGrid::GetXChunks() const {
+    return _x_chunks;
+}
+
+/**
+ * @brief Gets the number of chunk rows.
+ *
+ * @return The number of chunks in the y-axis.
+ */
+msize_t ChunkGrid::GetYChunks() const {
+    return _y_chunks;
+}
+
+/**
+ * @brief Tells if the grid has no chunks.
+ *
+ * @return True if there is no chunk.
+ */
+bool ChunkGrid::IsEmpty() const {
+    return 0 == _x_chunks || 0 == _y_chunks;
+}
+
+/**
+ * @brief Gets the chunk at the given grid position.
+ *
+ * @param x The chunk column.
+ * @param y The chunk row.
+ * @return The chunk geometry.
+ */
+Chunk ChunkGrid::GetChunk(msize_t x, msize_t y) const {
+    return Chunk(_x_origin + x * _chunk_x_size, _x_origin + (x + 1) * _chunk_x_size,
+                 _y_origin + y * _chunk_y_size, _y_origin + (y + 1) * _chunk_y_size);
+}
+
+/**
+ * @brief Gets the part of the image covered by the chunks, without the given number of outer chunk rings.
+ *        The rings never take more than half of the chunks of an axis.
+ *
+ * @param margin The number of outer chunk rings left out.
+ * @return The covered region (may be empty).
+ */
+Region ChunkGrid::GetRegion(msize_t margin) const {
+    msize_t x_margin = std::min(margin, _x_chunks / 2);
+    msize_t y_margin = std::min(margin, _y_chunks / 2);
+
+    return {_x_origin + x_margin * _chunk_x_size, _x_origin + (_x_chunks - x_margin) * _chunk_x_size,
+            _y_origin + y_margin * _chunk_y_size, _y_origin + (_y_chunks - y_margin) * _chunk_y_size};
+}
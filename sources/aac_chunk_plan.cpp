@@ -0,0 +1,152 @@
+#include <aac.h>
+
+/**
+ * @file aac_chunk_plan.cpp
+ * @brief Contains the implementation of the ChunkPlan class.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Constructs an empty ChunkPlan matching no image.
+ */
+ChunkPlan::ChunkPlan() :
+    _size_x(0), _size_y(0), _chunk_size(0), _ratio(0), _x_margin(0), _y_margin(0) {}
+
+/**
+ * @brief Constructs a ChunkPlan. The chunk height follows from the font ratio, the chunk grid,
+ *        the sub-cell bounds of the chunk converter and the image columns where sub-cells start
+ *        are computed once.
+ *
+ * @param size_x The image size in the x-axis.
+ * @param size_y The image size in the y-axis.
+ * @param chunk_size The chunk width.
+ * @param ratio The font width to height ratio.
+ * @param chunk_conv The chunk converter the sub-cells are taken from.
+ *
+ * @throws error_code An exception is thrown if the chunk converter is null, the ratio is not positive
+ *                    or the chunk size is 0 or bigger than the image.
+ */
+ChunkPlan::ChunkPlan(msize_t size_x, msize_t size_y, size_t chunk_size, float ratio, const ChunkConverter* chunk_conv) :
+    _size_x(size_x), _size_y(size_y), _chunk_size(chunk_size), _ratio(ratio) {
+
+    if (NULL == chunk_conv || !(ratio > 0)) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _grid = ChunkGrid(size_x, size_y, chunk_size, (size_t)((float)chunk_size / ratio));
+
+    if (_grid.IsEmpty()) {
+        throw AACException(error_codes::CHUNK_SIZE_ERROR);
+    }
+
+    chunk_conv->subcellBounds(_grid.GetChunkXSize(), _grid.GetChunkYSize(), _column_bounds, _row_bounds);
+
+    // sub-cell column runs in image coordinates
+    msize_t x_cells = GetXCells();
+    _column_starts.resize(_grid.GetXChunks() * x_cells + 1);
+    for (msize_t j = 0; j < _grid.GetXChunks(); j++) {
+        for (msize_t cell_column = 0; cell_column < x_cells; cell_column++) {
+            _column_starts[j * x_cells + cell_column] = _grid.GetXOrigin() + j * _grid.GetChunkXSize() + _column_bounds[cell_column];
+        }
+    }
+    _column_starts[_grid.GetXChunks() * x_cells] = _grid.GetXOrigin() + _grid.GetXChunks() * _grid.GetChunkXSize();
+
+    msize_t margin = chunk_conv->chunkMargin();
+    _x_margin = std::min(margin, _grid.GetXChunks() / 2);
+    _y_margin = std::min(margin, _grid.GetYChunks() / 2);
+}
+
+/**
+ * @brief Tells if the plan was made for the given dimensions.
+ *
+ * @param size_x The image size in the x-axis.
+ * @param size_y The image size in the y-axis.
+ * @param chunk_size The chunk width.
+ * @param ratio The font width to height ratio.
+ * @return True if the plan can be reused.
+ */
+bool ChunkPlan::Matches(msize_t size_x, msize_t size_y, size_t chunk_size, float ratio) const {
+    return !_grid.IsEmpty() && _size_x == size_x && _size_y == size_y && _chunk_size == chunk_size && _ratio == ratio;
+}
+
+/**
+ * @brief Gets the chunk grid.
+ *
+ * @return The chunk grid.
+ */
+const ChunkGrid& ChunkPlan::GetGrid() const {
+    return _grid;
+}
+
+/**
+ * @brief Gets the sub-cell column bounds relative to the chunk start.
+ *
+ * @return The column bounds (first is 0, last is the chunk width).
+ */
+const std::vector<msize_t>& ChunkPlan::GetColumnBounds() const {
+    return _column_bounds;
+}
+
+/**
+ * @brief Gets the sub-cell row bounds relative to the chunk start.
+ *
+ * @return The row bounds (first is 0, last is the chunk height).
+ */
+const std::vector<msize_t>& ChunkPlan::GetRowBounds() const {
+    return _row_bounds;
+}
+
+/**
+ * @brief Gets the image columns where the sub-cells of every chunk column start.
+ *
+ * @return The column starts, the last value is the end of the last chunk.
+ */
+const std::vector<msize_t>& ChunkPlan::GetColumnStarts() const {
+    return _column_starts;
+}
+
+/**
+ * @brief Gets the number of sub-cells of a chunk in the x-axis.
+ *
+ * @return The number of sub-cell columns.
+ */
+msize_t ChunkPlan::GetXCells() const {
+    return _column_bounds.empty() ? 0 : _column_bounds.size() - 1;
+}
+
+/**
+ * @brief Gets the number of sub-cells of a chunk in the y-axis.
+ *
+ * @return The number of sub-cell rows.
+ */
+msize_t ChunkPlan::GetYCells() const {
+    return _row_bounds.empty() ? 0 : _row_bounds.size() - 1;
+}
+
+/**
+ * @brief Gets the number of ignored chunk columns on each side.
+ *
+ * @return The x margin in chunks.
+ */
+msize_t ChunkPlan::GetXMargin() const {
+    return _x_margin;
+}
+
+/**
+ * @brief Gets the number of ignored chunk rows on each side.
+ *
+ * @return The y margin in chunks.
+ */
+msize_t ChunkPlan::GetYMargin() const {
+    return _y_margin;
+}
+
+/**
+ * @brief Gets the region covered by the chunks the converter does not ignore.
+ *
+ * @return The region.
+ */
+Region ChunkPlan::GetRegion() const {
+    return _grid.GetRegion(std::max(_x_margin, _y_margin));
+}
@@ -0,0 +1,206 @@
+#include <aac.h>
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file aac_chunk_stats.cpp
+ * @brief Contains the implementation of the ChunkStats class.
+ */
+
+using namespace AAC;
+
+static constexpr double PI = 3.14159265358979323846;
+
+/**
+ * @brief Constructs empty ChunkStats.
+ */
+ChunkStats::ChunkStats() : _x_chunks(0), _y_chunks(0) {}
+
+/**
+ * @brief Computes the statistics of every chunk of the grid in a single pass over its pixels.
+ *        Every row of a chunk row band is read once: central difference gradients of the row are
+ *        laid out contiguously and then every chunk accumulates its sums, squares, extremes and
+ *        gradient structure tensor in plain loops the compiler can vectorize. The dominant orientation
+ *        is the gradient direction of the structure tensor, modulo half turn mapped onto 0..255
+ *        (0 means horizontal gradient) like BC_Edges directions. Chunk rows are split between threads.
+ *
+ * @param grid The chunk grid.
+ * @param brightness_matrix A pointer to the brightness matrix the grid divides.
+ * @param threads Number of threads used for the chunk rows (0 means hardware concurrency).
+ *
+ * @throws error_code An exception is thrown if the brightness matrix is null or smaller than the grid.
+ */
+ChunkStats::ChunkStats(const ChunkGrid& grid, Matrix<uint8_t>* brightness_matrix, unsigned threads) :
+    _x_chunks(grid.GetXChunks()), _y_chunks(grid.GetYChunks()) {
+
+    if (NULL == brightness_matrix) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    const msize_t size_x = brightness_matrix->GetXSize();
+    const msize_t size_y = brightness_matrix->GetYSize();
+    const Region region = grid.GetRegion();
+
+    if (region.X_end_index > size_x || region.Y_end_index > size_y) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    const msize_t chunks = _x_chunks * _y_chunks;
+    _means.assign(chunks, 0);
+    _variances.assign(chunks, 0);
+    _mins.assign(chunks, 0);
+    _maxs.assign(chunks, 0);
+    _orientations.assign(chunks, 0);
+
+    if (0 == chunks) {
+        return;
+    }
+
+    const msize_t chunk_x_size = grid.GetChunkXSize();
+    const msize_t chunk_y_size = grid.GetChunkYSize();
+    const msize_t x_start = region.X_start_index;
+    const msize_t x_end = region.X_end_index;
+
+    ParallelBands(0, _y_chunks, threads, [&](unsigned, msize_t band_start, msize_t band_end) {
+        std::vector<int16_t> gx(size_x), gy(size_x);
+        std::vector<uint64_t> sums(_x_chunks), squares(_x_chunks);
+        std::vector<uint8_t> mins(_x_chunks), maxs(_x_chunks);
+        std::vector<long long> jxx(_x_chunks), jyy(_x_chunks), jxy(_x_chunks);
+
+        for (msize_t i = band_start; i < band_end; i++) {
+            std::fill(sums.begin(), sums.end(), 0);
+            std::fill(squares.begin(), squares.end(), 0);
+            std::fill(mins.begin(), mins.end(), 255);
+            std::fill(maxs.begin(), maxs.end(), 0);
+            std::fill(jxx.begin(), jxx.end(), 0);
+            std::fill(jyy.begin(), jyy.end(), 0);
+            std::fill(jxy.begin(), jxy.end(), 0);
+
+            msize_t y_start = grid.GetYOrigin() + i * chunk_y_size;
+            for (msize_t y = y_start; y < y_start + chunk_y_size; y++) {
+                const uint8_t* up = (*brightness_matrix)[y > 0 ? y - 1 : 0].data();
+                const uint8_t* mid = (*brightness_matrix)[y].data();
+                const uint8_t* down = (*brightness_matrix)[std::min(y + 1, size_y - 1)].data();
+
+                // gradients of the row, border pixels of the image are replicated
+                for (msize_t x = x_start; x < x_end; x++) {
+                    gy[x] = down[x] - up[x];
+                }
+                for (msize_t x = std::max<msize_t>(x_start, 1); x < std::min(x_end, size_x - 1); x++) {
+                    gx[x] = mid[x + 1] - mid[x - 1];
+                }
+                gx[x_start] = mid[std::min(x_start + 1, size_x - 1)] - mid[x_start > 0 ? x_start - 1 : 0];
+                gx[x_end - 1] = mid[std::min(x_end, size_x - 1)] - mid[x_end > 1 ? x_end - 2 : 0];
+
+                for (msize_t j = 0; j < _x_chunks; j++) {
+                    const msize_t cx_start = x_start + j * chunk_x_size;
+                    const msize_t cx_end = cx_start + chunk_x_size;
+                    uint64_t sum = 0, square = 0;
+                    uint8_t low = mins[j], high = maxs[j];
+                    long long xx = 0, yy = 0, xy = 0;
+
+                    for (msize_t x = cx_start; x < cx_end; x++) {
+                        const unsigned value = mid[x];
+                        sum += value;
+                        square += value * value;
+                        low = std::min<uint8_t>(low, mid[x]);
+                        high = std::max<uint8_t>(high, mid[x]);
+                        xx += gx[x] * gx[x];
+                        yy += gy[x] * gy[x];
+                        xy += gx[x] * gy[x];
+                    }
+
+                    sums[j] += sum;
+                    squares[j] += square;
+                    mins[j] = low;
+                    maxs[j] = high;
+                    jxx[j] += xx;
+                    jyy[j] += yy;
+                    jxy[j] += xy;
+                }
+            }
+
+            const uint64_t area = (uint64_t)chunk_x_size * chunk_y_size;
+            for (msize_t j = 0; j < _x_chunks; j++) {
+                const msize_t index = i * _x_chunks + j;
+                const double mean = (double)sums[j] / area;
+
+                _means[index] = (uint8_t)((sums[j] + area / 2) / area);
+                _variances[index] = (float)std::max(0.0, (double)squares[j] / area - mean * mean);
+                _mins[index] = mins[j];
+                _maxs[index] = maxs[j];
+
+                // orientation modulo half turn mapped onto 0..255
+                double angle = 0.5 * std::atan2(2.0 * jxy[j], (double)(jxx[j] - jyy[j]));
+                if (angle < 0) {
+                    angle += PI;
+                }
+                _orientations[index] = (uint8_t)((unsigned)(angle * 256.0 / PI) & 0xFF);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Gets the number of chunks in the x-axis.
+ *
+ * @return The number of chunk columns.
+ */
+msize_t ChunkStats::GetXChunks() const {
+    return _x_chunks;
+}
+
+/**
+ * @brief Gets the number of chunks in the y-axis.
+ *
+ * @return The number of chunk rows.
+ */
+msize_t ChunkStats::GetYChunks() const {
+    return _y_chunks;
+}
+
+/**
+ * @brief Gets the rounded mean brightness of every chunk.
+ *
+ * @return The means.
+ */
+const std::vector<uint8_t>& ChunkStats::GetMeans() const {
+    return _means;
+}
+
+/**
+ * @brief Gets the brightness variance of every chunk.
+ *
+ * @return The variances.
+ */
+const std::vector<float>& ChunkStats::GetVariances() const {
+    return _variances;
+}
+
+/**
+ * @brief Gets the minimal brightness of every chunk.
+ *
+ * @return The minimums.
+ */
+const std::vector<uint8_t>& ChunkStats::GetMins() const {
+    return _mins;
+}
+
+/**
+ * @brief Gets the maximal brightness of every chunk.
+ *
+ * @return The maximums.
+ */
+const std::vector<uint8_t>& ChunkStats::GetMaxs() const {
+    return _maxs;
+}
+
+/**
+ * @brief Gets the dominant gradient orientation of every chunk.
+ *
+ * @return The orientations, half turn mapped onto 0..255.
+ */
+const std::vector<uint8_t>& ChunkStats::GetOrientations() const {
+    return _orientations;
+}
@@ -0,0 +1,305 @@
+#include <aac.h>
+
+#include <cstring>
+
+/**
+ * @file aac_conversion_plan.cpp
+ * @brief Contains the implementation of the ConversionPlan class.
+ */
+
+using namespace AAC;
+
+#define HASH_MULTIPLIER 0x9E3779B97F4A7C15ull
+
+/**
+ * @brief Mixes a run of bytes into a hash, eight bytes at a time.
+ *
+ * @param hash The hash so far.
+ * @param bytes The bytes.
+ * @param count The number of bytes.
+ * @return The updated hash.
+ */
+static inline uint64_t hashBytes(uint64_t hash, const uint8_t* bytes, msize_t count) {
+    msize_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * HASH_MULTIPLIER;
+        hash ^= hash >> 29;
+    }
+
+    uint64_t tail = count - i;
+    for (; i < count; i++) {
+        tail = (tail << 8) | bytes[i];
+    }
+    hash = (hash ^ tail) * HASH_MULTIPLIER;
+    return hash ^ (hash >> 29);
+}
+
+/**
+ * @brief Constructs a ConversionPlan. The chunk geometry is computed and every buffer the conversion
+ *        needs is allocated here, so frames of the given size and pixel type are converted without setup.
+ *
+ * @param size_x The frame size in the x-axis.
+ * @param size_y The frame size in the y-axis.
+ * @param pixel_type The pixel type of the frames.
+ * @param chunk_size The chunk width.
+ * @param brightness_conv The brightness converter.
+ * @param chunk_conv The chunk converter.
+ * @param ratio The font width to height ratio.
+ * @param fusion Flag indicating whether row capable brightness converters are fused with the chunk stage.
+ *
+ * @throws error_code An exception is thrown if a converter is null, the ratio is not positive
+ *                    or the chunk size is 0 or bigger than the frame.
+ */
+ConversionPlan::ConversionPlan(msize_t size_x, msize_t size_y, Pixel_Type pixel_type, size_t chunk_size, BrightnessConverter* brightness_conv,
+                               ChunkConverter* chunk_conv, float ratio, bool fusion) :
+    _brightness_conv(brightness_conv), _chunk_conv(chunk_conv), _size_x(size_x), _size_y(size_y), _pixel_type(pixel_type),
+    _chunk_size(chunk_size), _ratio(ratio), _fusion(fusion), _plan(size_x, size_y, chunk_size, ratio, chunk_conv),
+    _sums(_plan.GetGrid().GetXChunks() * _plan.GetXCells(), _plan.GetGrid().GetYChunks() * _plan.GetYCells()),
+    _row(size_x), _transparent_chunks(_plan.GetGrid().GetXChunks(), _plan.GetGrid().GetYChunks()), _threshold(0),
+    _tracking(false), _hashed(false), _hashes(_plan.GetGrid().GetXChunks() * _plan.GetGrid().GetYChunks()),
+    _row_hashes(_plan.GetGrid().GetXChunks()),
+    _changed_chunks(_plan.GetGrid().GetXChunks(), _plan.GetGrid().GetYChunks()) {
+
+    if (NULL == brightness_conv) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _binary = chunk_conv->pixelThreshold(_threshold);
+    _bits.resize(_binary ? (size_x + 63) / 64 : 0);
+}
+
+/**
+ * @brief Tells if the plan was made for the given frames and settings.
+ *
+ * @param size_x The frame size in the x-axis.
+ * @param size_y The frame size in the y-axis.
+ * @param pixel_type The pixel type of the frames.
+ * @param chunk_size The chunk width.
+ * @param ratio The font width to height ratio.
+ * @param fusion The fusion flag.
+ * @return True if the plan can be reused.
+ */
+bool ConversionPlan::Matches(msize_t size_x, msize_t size_y, Pixel_Type pixel_type, size_t chunk_size, float ratio, bool fusion) const {
+    return _size_x == size_x && _size_y == size_y && _pixel_type == pixel_type && _chunk_size == chunk_size && _ratio == ratio && _fusion == fusion;
+}
+
+/**
+ * @brief Gets the chunk geometry of the plan.
+ *
+ * @return The chunk plan.
+ */
+const ChunkPlan& ConversionPlan::GetChunkPlan() const {
+    return _plan;
+}
+
+/**
+ * @brief Enables or disables change tracking. When enabled, the fused pipeline hashes the source pixels
+ *        of every chunk row right before converting it and compares the hashes with the previous frame,
+ *        only changed chunks are converted and summed again while the others keep their sums. The first
+ *        frame after enabling counts every chunk as changed. The matrix path converts whole frames
+ *        anyway, so there tracking is skipped and every chunk counts as changed.
+ *
+ * @param tracking The tracking flag (disabled by default).
+ *
+ * @throws error_code An exception is thrown if tracking is enabled for a brightness converter
+ *                    which is not pixel local, reused sums would be wrong for it.
+ */
+void ConversionPlan::SetChangeTracking(bool tracking) {
+
+    if (tracking && !_brightness_conv->IsPixelLocal()) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _tracking = tracking;
+    _hashed = false;
+}
+
+/**
+ * @brief Gets the chunks changed by the last frame. Without change tracking every chunk is changed.
+ *
+ * @return Bit per chunk, set if the chunk's source pixels differ from the previous frame.
+ */
+const BitMatrix& ConversionPlan::GetChangedChunks() const {
+    return _changed_chunks;
+}
+
+/**
+ * @brief Sums the chunk sub-cells in a single pass over the frame. Brightness is computed row by row
+ *        into the row buffer and summed straight into the sub-cell sums. With change tracking the
+ *        source pixels of a chunk row are hashed right before it is converted, so they are read from
+ *        memory once; only the span of changed chunks is converted and summed, the others keep their
+ *        sums from the previous frame.
+ *
+ * @param frame The frame to sum.
+ */
+void ConversionPlan::sumRows(Image* frame) {
+
+    const ChunkGrid& grid = _plan.GetGrid();
+    const msize_t x_nof_chunks = grid.GetXChunks();
+    const msize_t y_nof_chunks = grid.GetYChunks();
+    const msize_t x_chunk_size = grid.GetChunkXSize();
+    const msize_t y_chunk_size = grid.GetChunkYSize();
+    const std::vector<msize_t>& row_bounds = _plan.GetRowBounds();
+    const std::vector<msize_t>& column_starts = _plan.GetColumnStarts();
+    const msize_t x_cells = _plan.GetXCells();
+    const msize_t y_cells = _plan.GetYCells();
+    const msize_t channels = frame->GetChannels();
+
+    // chunks in the ignored outer rings keep zero sums
+    msize_t x_margin = _plan.GetXMargin();
+    msize_t y_margin = _plan.GetYMargin();
+
+    uint8_t* row = _row.data();
+    uint64_t* bits = _bits.data();
+
+    _brightness_conv->prepareRows(frame, _plan.GetRegion());
+
+    for (msize_t i = y_margin; i + y_margin < y_nof_chunks; i++) {
+
+        const msize_t chunk_y_start = grid.GetYOrigin() + i * y_chunk_size;
+
+        // hash the source pixels of the chunk row, they stay in cache for the conversion below
+        if (_tracking) {
+            std::fill(_row_hashes.begin(), _row_hashes.end(), 0);
+            for (msize_t y = chunk_y_start; y < chunk_y_start + y_chunk_size; y++) {
+                const uint8_t* raw = frame->GetRawRow(y);
+                for (msize_t j = x_margin; j + x_margin < x_nof_chunks; j++) {
+                    _row_hashes[j] = hashBytes(_row_hashes[j], raw + (grid.GetXOrigin() + j * x_chunk_size) * channels, x_chunk_size * channels);
+                }
+            }
+
+            for (msize_t j = x_margin; j + x_margin < x_nof_chunks; j++) {
+                uint64_t& previous = _hashes[i * x_nof_chunks + j];
+                if (!_hashed || previous != _row_hashes[j]) {
+                    _changed_chunks.Set(j, i, true);
+                }
+                previous = _row_hashes[j];
+            }
+        }
+
+        // only the span of changed chunks is converted, rows without changed chunks are skipped
+        msize_t first = x_nof_chunks, last = 0;
+        for (msize_t j = x_margin; j + x_margin < x_nof_chunks; j++) {
+            if (_changed_chunks.Get(j, i)) {
+                first = std::min(first, j);
+                last = j + 1;
+            }
+        }
+        if (first >= last) {
+            continue;
+        }
+
+        msize_t x_start = column_starts[first * x_cells];
+        msize_t x_end = column_starts[last * x_cells];
+
+        for (msize_t cell_row = 0; cell_row < y_cells; cell_row++) {
+            unsigned long* sums_row = _sums[i * y_cells + cell_row].data();
+            msize_t y_start = chunk_y_start + row_bounds[cell_row];
+            msize_t y_end = chunk_y_start + row_bounds[cell_row + 1];
+
+            for (msize_t j = first; j < last; j++) {
+                if (_changed_chunks.Get(j, i)) {
+                    std::fill(sums_row + j * x_cells, sums_row + (j + 1) * x_cells, 0);
+                }
+            }
+
+            for (msize_t y = y_start; y < y_end; y++) {
+                _brightness_conv->convertRow(frame, y, x_start, x_end, row);
+
+                // binary converters count bright pixels of the packed row
+                if (_binary) {
+                    BitMatrix::PackRow(row, x_start, x_end, _threshold, bits);
+                }
+
+                for (msize_t j = first; j < last; j++) {
+                    if (!_changed_chunks.Get(j, i)) {
+                        continue;
+                    }
+
+                    for (msize_t cell = j * x_cells; cell < (j + 1) * x_cells; cell++) {
+                        if (_binary) {
+                            sums_row[cell] += BitMatrix::CountRow(bits, column_starts[cell], column_starts[cell + 1]);
+                            continue;
+                        }
+
+                        unsigned long sum = 0;
+                        for (msize_t x = column_starts[cell]; x < column_starts[cell + 1]; x++) {
+                            sum += row[x];
+                        }
+                        sums_row[cell] += sum;
+                    }
+                }
+            }
+        }
+    }
+
+    if (_tracking) {
+        _hashed = true;
+    }
+}
+
+/**
+ * @brief Sums the chunk sub-cells of the brightness matrix of the frame. Used by brightness converters
+ *        that can not convert single rows, those still allocate their brightness matrix.
+ *
+ * @param frame The frame to sum.
+ */
+void ConversionPlan::sumMatrix(Image* frame) {
+
+    const ChunkGrid& grid = _plan.GetGrid();
+    std::shared_ptr<Matrix<uint8_t>> brightness_m = _brightness_conv->convertRegion(frame, _plan.GetRegion());
+
+    if (NULL == brightness_m) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    // fully transparent chunks
+    for (msize_t y = 0; y < grid.GetYChunks(); y++) {
+        for (msize_t x = 0; x < grid.GetXChunks(); x++) {
+            Chunk chunk = grid.GetChunk(x, y);
+            _transparent_chunks.Set(x, y, _brightness_conv->IsTransparent(chunk.GetXStart(), chunk.GetXEnd(), chunk.GetYStart(), chunk.GetYEnd()));
+        }
+    }
+
+    _chunk_conv->sumChunks(_plan, brightness_m.get(), &_transparent_chunks, _sums);
+}
+
+/**
+ * @brief Converts a frame to ASCII art. The art is written into the given string, which keeps its
+ *        capacity between frames, so converting a stream reuses the buffers of the plan and the string.
+ *        With change tracking only the chunks changed since the previous frame are summed again,
+ *        GetChangedChunks tells which cells of the art may differ. Parallel stages of the chunk converter
+ *        (ChunkConverter::SetThreads) still start their worker threads for every frame; with a single
+ *        thread a frame is converted without allocations.
+ *
+ * @param frame The frame, of the size and pixel type the plan was made for.
+ * @param art Output ASCII art.
+ *
+ * @throws error_code An exception is thrown if the frame is null or does not match the plan.
+ */
+void ConversionPlan::Run(Image* frame, std::string& art) {
+
+    if (NULL == frame || frame->GetSizeX() != _size_x || frame->GetSizeY() != _size_y || frame->GetPixelType() != _pixel_type) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    // tracked frames start with no changed chunks (but the first), sumRows marks the changed ones
+    const bool fused = _fusion && _brightness_conv->SupportsRows();
+    const bool all_changed = !(_tracking && fused && _hashed);
+    for (msize_t y = 0; y < _changed_chunks.GetYSize(); y++) {
+        for (msize_t x = 0; x < _changed_chunks.GetXSize(); x++) {
+            _changed_chunks.Set(x, y, all_changed);
+        }
+    }
+
+    if (fused) {
+        sumRows(frame);
+    }
+    else {
+        sumMatrix(frame);
+    }
+
+    _chunk_conv->convertSums(&_sums, _plan.GetColumnBounds(), _plan.GetRowBounds(), art);
+}
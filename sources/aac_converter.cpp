@@ -1,5 +1,7 @@
 #include <aac.h>
 
+#include <algorithm>
+
 /**
  * @file aac_converter.cpp
  * @brief Contains the implementation of the Converter class.
@@ -7,59 +9,132 @@
 
 using namespace AAC;
 
+/**
+ * @brief Area weights of the sub-cells along one axis. Sub-cell c covers the pixels
+ *        first[c] .. first[c] + (offsets[c + 1] - offsets[c]) with the weights stored from offsets[c].
+ *        A weight is the pixel length covered by the sub-cell in units of 1 / (chunks * chunk_size).
+ */
+struct AxisWeights {
+    std::vector<msize_t> first;
+    std::vector<msize_t> offsets;
+    std::vector<uint32_t> weights;
+};
+
+/**
+ * @brief Spreads the nominal sub-cell bounds of the given number of chunks evenly over the axis
+ *        and computes the area weights of every sub-cell.
+ *
+ * @param size The image size along the axis.
+ * @param chunks The number of chunks along the axis.
+ * @param chunk_size The nominal chunk size the bounds are given for.
+ * @param bounds The nominal sub-cell bounds of a chunk.
+ * @return The sub-cell weights.
+ */
+static AxisWeights axisWeights(msize_t size, msize_t chunks, msize_t chunk_size, const std::vector<msize_t>& bounds) {
+
+    const uint64_t denominator = (uint64_t)chunks * chunk_size;
+    const msize_t cells = bounds.size() - 1;
+
+    AxisWeights axis;
+    axis.first.resize(chunks * cells);
+    axis.offsets.resize(chunks * cells + 1, 0);
+
+    for (msize_t chunk = 0; chunk < chunks; chunk++) {
+        for (msize_t cell = 0; cell < cells; cell++) {
+            uint64_t start = (uint64_t)(chunk * chunk_size + bounds[cell]) * size;
+            uint64_t end = (uint64_t)(chunk * chunk_size + bounds[cell + 1]) * size;
+            msize_t index = chunk * cells + cell;
+
+            axis.first[index] = start / denominator;
+            for (uint64_t pixel = start / denominator; pixel * denominator < end; pixel++) {
+                uint64_t covered = std::min(end, (pixel + 1) * denominator) - std::max(start, pixel * denominator);
+                axis.weights.push_back((uint32_t)covered);
+            }
+            axis.offsets[index + 1] = axis.weights.size();
+        }
+    }
+
+    return axis;
+}
+
 /**
  * @brief Constructs a Converter object with the specified brightness converter and chunk converter.
  *
  * @param brightness_conv The brightness converter.
  * @param chunk_conv The chunk converter.
+ * @param ratio The font width to height ratio used for the chunks division.
+ *
+ * @throws error_code An exception is thrown if the ratio is not positive.
  */
-Converter::Converter(BrightnessConverter* brightness_conv, ChunkConverter* chunk_conv) :
-    _brightness_conv(brightness_conv), _chunk_conv(chunk_conv) {}
+Converter::Converter(BrightnessConverter* brightness_conv, ChunkConverter* chunk_conv, float ratio) :
+    _brightness_conv(brightness_conv), _chunk_conv(chunk_conv), _fusion(true) {
+    SetRatio(ratio);
+}
 
 /**
- * @brief Generates chunks from the image using the specified chunk size and brightness matrix.
+ * @brief Gets the font width to height ratio used for the chunks division.
  *
- * @param img The image to generate chunks from.
- * @param chunk_size The size of each chunk.
- * @param brightness_matrix The shared pointer to the brightness matrix.
- * @return The matrix of generated chunks.
- * @throw std::error_code if the brightness matrix or image is null.
+ * @return The ratio.
  */
-Matrix<Chunk>* Converter::generateChunks(Image *img, size_t chunk_size, std::shared_ptr<Matrix<uint8_t>> brightness_matrix) {
+float Converter::GetRatio() const {
+    return _ratio;
+}
 
-    if (NULL == brightness_matrix) {
+/**
+ * @brief Sets the font width to height ratio used for the chunks division.
+ *
+ * @param ratio The ratio of the target font cell.
+ *
+ * @throws error_code An exception is thrown if the ratio is not positive.
+ */
+void Converter::SetRatio(float ratio) {
+
+    if (!(ratio > 0)) {
         throw AACException(error_codes::INVALID_ARGUMENTS);
     }
 
-    size_t x_nof_chunks = img->GetSizeX() / chunk_size;
-    size_t lcols_to_cut = (img->GetSizeX() % chunk_size) / 2;
+    _ratio = ratio;
+}
 
-    size_t y_chunk_size = (size_t)((float)chunk_size / _ratio);
-    size_t y_nof_chunks = img->GetSizeY() / y_chunk_size;
-    size_t urows_to_cut = (img->GetSizeY() % y_chunk_size) / 2;
+/**
+ * @brief Enables or disables the fused pipeline. When enabled and the brightness converter
+ *        supports row conversion, brightness is accumulated straight into chunk sub-cell sums
+ *        and the full brightness matrix is never created. The art is the same in both modes.
+ *
+ * @param fusion The fusion flag (enabled by default).
+ */
+void Converter::SetFusion(bool fusion) {
+    _fusion = fusion;
+}
 
-    Matrix<Chunk>* arr = new Matrix<Chunk>(x_nof_chunks, y_nof_chunks);
+/**
+ * @brief Gets the chunk plan of an image of the given size. The plan of the last call is
+ *        kept and reused as long as the image size, chunk size and ratio stay the same.
+ *
+ * @param size_x The image size in the x-axis.
+ * @param size_y The image size in the y-axis.
+ * @param chunk_size The chunk width.
+ * @return The chunk plan.
+ * @throw std::error_code if the chunk converter is null or the chunk size is 0 or bigger than the image.
+ */
+const ChunkPlan& Converter::GetPlan(msize_t size_x, msize_t size_y, size_t chunk_size) {
 
-    for (size_t i = 0; i < y_nof_chunks; i++) {
-        for (size_t j = 0; j < x_nof_chunks; j++) {
-            (*arr)[i][j].SetChunk(lcols_to_cut + j * chunk_size,
-                                  lcols_to_cut + (j + 1) * chunk_size,
-                                  urows_to_cut + i * y_chunk_size,
-                                  urows_to_cut + (i + 1) * y_chunk_size,
-                                  brightness_matrix);
-        }
+    if (!_plan.Matches(size_x, size_y, chunk_size, _ratio)) {
+        _plan = ChunkPlan(size_x, size_y, chunk_size, _ratio, _chunk_conv);
     }
 
-    return arr;
+    return _plan;
 }
 
 /**
- * @brief Creates ASCII art from the image using the specified chunk size.
+ * @brief Creates ASCII art from the image using the specified chunk size. The conversion plan
+ *        of the last call is reused while the image size, pixel type, chunk size and settings stay the same.
+ *        The cached plan is replaced without locking, so calls must not run concurrently on one converter.
  *
  * @param img The image to create ASCII art from.
  * @param chunk_size The size of each chunk.
  * @return The generated ASCII art.
- * @throw std::error_code if the image is null.
+ * @throw std::error_code if the image is null or the chunk size is 0 or bigger than the image.
  */
 std::string Converter::CreateArt(Image* img, size_t chunk_size) {
 
@@ -67,9 +142,264 @@ std::string Converter::CreateArt(Image* img, size_t chunk_size) {
         throw AACException(error_codes::INVALID_ARGUMENTS);
     }
 
-    std::shared_ptr<Matrix<uint8_t>> brightness_m = _brightness_conv->convert(img);
-    Matrix<Chunk>* chunked_image = generateChunks(img, chunk_size, brightness_m);
-    std::string art = _chunk_conv->convert(chunked_image);
-    delete chunked_image;
+    if (NULL == _conversion || !_conversion->Matches(img->GetSizeX(), img->GetSizeY(), img->GetPixelType(), chunk_size, _ratio, _fusion)) {
+        _conversion.reset(new ConversionPlan(img->GetSizeX(), img->GetSizeY(), img->GetPixelType(), chunk_size,
+                                             _brightness_conv, _chunk_conv, _ratio, _fusion));
+    }
+
+    std::string art;
+    _conversion->Run(img, art);
+    return art;
+}
+
+/**
+ * @brief Creates ASCII art of exactly the given number of columns and rows. Chunks get fractional
+ *        bounds spread over the whole image and every sub-cell is the area weighted sum of the pixels
+ *        it partially covers. Weights are precomputed per column and per row, so the cost stays close
+ *        to the integer chunk path. Sums are scaled to the nominal chunk size of rounded up pixels.
+ *
+ * @param img The image to create ASCII art from.
+ * @param columns The number of characters in a line.
+ * @param rows The number of lines.
+ * @return The generated ASCII art.
+ * @throw std::error_code if the image is null or the number of columns or rows is 0.
+ */
+std::string Converter::CreateArt(Image* img, size_t columns, size_t rows) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    const msize_t size_x = img->GetSizeX();
+    const msize_t size_y = img->GetSizeY();
+
+    if (0 == columns || 0 == rows || 0 == size_x || 0 == size_y) {
+        throw AACException(error_codes::CHUNK_SIZE_ERROR);
+    }
+
+    const msize_t chunk_size = (size_x + columns - 1) / columns;
+    const msize_t y_chunk_size = (size_y + rows - 1) / rows;
+
+    std::vector<msize_t> column_bounds, row_bounds;
+    _chunk_conv->subcellBounds(chunk_size, y_chunk_size, column_bounds, row_bounds);
+    msize_t x_cells = column_bounds.size() - 1;
+    msize_t y_cells = row_bounds.size() - 1;
+
+    AxisWeights x_weights = axisWeights(size_x, columns, chunk_size, column_bounds);
+    AxisWeights y_weights = axisWeights(size_y, rows, y_chunk_size, row_bounds);
+
+    // chunks in the ignored outer rings keep zero sums
+    msize_t margin = _chunk_conv->chunkMargin();
+    msize_t x_margin = std::min<msize_t>(margin, columns / 2);
+    msize_t y_margin = std::min<msize_t>(margin, rows / 2);
+    msize_t first_cell = x_margin * x_cells;
+    msize_t last_cell = (columns - x_margin) * x_cells;
+    msize_t first_cell_row = y_margin * y_cells;
+    msize_t last_cell_row = (rows - y_margin) * y_cells;
+
+    Matrix<unsigned long> sums(columns * x_cells, rows * y_cells);
+
+    if (first_cell >= last_cell || first_cell_row >= last_cell_row) {
+        std::string art;
+        _chunk_conv->convertSums(&sums, column_bounds, row_bounds, art);
+        return art;
+    }
+
+    Region region = {x_weights.first[first_cell],
+                     x_weights.first[last_cell - 1] + x_weights.offsets[last_cell] - x_weights.offsets[last_cell - 1],
+                     y_weights.first[first_cell_row],
+                     y_weights.first[last_cell_row - 1] + y_weights.offsets[last_cell_row] - y_weights.offsets[last_cell_row - 1]};
+
+    // brightness rows come from the row pipeline when possible
+    const bool fused = _fusion && _brightness_conv->SupportsRows();
+    std::shared_ptr<Matrix<uint8_t>> brightness_m;
+    std::vector<uint8_t> row_buffer(size_x);
+
+    if (fused) {
+        _brightness_conv->prepareRows(img, region);
+    }
+    else {
+        brightness_m = _brightness_conv->convertRegion(img, region);
+        if (NULL == brightness_m) {
+            throw AACException(error_codes::INVALID_ARGUMENTS);
+        }
+    }
+
+    uint8_t threshold = 0;
+    bool binary = _chunk_conv->pixelThreshold(threshold);
+    msize_t loaded_y = size_y;
+    const uint8_t* row = NULL;
+
+    // weighted sums scale with the image area, so they are narrowed only after normalisation
+    std::vector<uint64_t> cell_sums(columns * x_cells);
+    const uint64_t image_area = (uint64_t)size_x * size_y;
+
+    for (msize_t cell_row = first_cell_row; cell_row < last_cell_row; cell_row++) {
+        unsigned long* sums_row = sums[cell_row].data();
+        std::fill(cell_sums.begin() + first_cell, cell_sums.begin() + last_cell, 0);
+        const uint32_t* row_weights = &y_weights.weights[y_weights.offsets[cell_row]];
+        msize_t rows_count = y_weights.offsets[cell_row + 1] - y_weights.offsets[cell_row];
+
+        for (msize_t k = 0; k < rows_count; k++) {
+            msize_t y = y_weights.first[cell_row] + k;
+
+            // neighbouring sub-cells share their boundary rows
+            if (y != loaded_y) {
+                if (fused) {
+                    _brightness_conv->convertRow(img, y, region.X_start_index, region.X_end_index, row_buffer.data());
+                    if (binary) {
+                        for (msize_t x = region.X_start_index; x < region.X_end_index; x++) {
+                            row_buffer[x] = row_buffer[x] > threshold;
+                        }
+                    }
+                    row = row_buffer.data();
+                }
+                else if (binary) {
+                    const uint8_t* src = (*brightness_m)[y].data();
+                    for (msize_t x = region.X_start_index; x < region.X_end_index; x++) {
+                        row_buffer[x] = src[x] > threshold;
+                    }
+                    row = row_buffer.data();
+                }
+                else {
+                    row = (*brightness_m)[y].data();
+                }
+                loaded_y = y;
+            }
+
+            for (msize_t cell = first_cell; cell < last_cell; cell++) {
+                const uint32_t* column_weights = &x_weights.weights[x_weights.offsets[cell]];
+                const uint8_t* pixels = row + x_weights.first[cell];
+                msize_t columns_count = x_weights.offsets[cell + 1] - x_weights.offsets[cell];
+                uint64_t sum = 0;
+
+                for (msize_t x = 0; x < columns_count; x++) {
+                    sum += (uint64_t)column_weights[x] * pixels[x];
+                }
+                cell_sums[cell] += sum * row_weights[k];
+            }
+        }
+
+        // weights of a sub-cell add up to its nominal area times the image area
+        for (msize_t cell = first_cell; cell < last_cell; cell++) {
+            sums_row[cell] = (unsigned long)((cell_sums[cell] + image_area / 2) / image_area);
+        }
+    }
+
+    std::string art;
+    _chunk_conv->convertSums(&sums, column_bounds, row_bounds, art);
+    return art;
+}
+
+/**
+ * @brief Creates ASCII art from a brightness pyramid using the specified chunk size. Sub-cells are
+ *        summed on the coarsest level that still has at least one sample per sub-cell, and the sums
+ *        are scaled back to full resolution units, so the art matches the full resolution conversion
+ *        up to the level averaging. Binary converters threshold the averaged samples instead of the
+ *        pixels, which only approximates their bright pixel counts on coarser levels.
+ *
+ * @param pyramid The brightness pyramid of the image.
+ * @param chunk_size The size of each chunk.
+ * @return The generated ASCII art.
+ * @throw std::error_code if the pyramid is null or the chunk grid is empty.
+ */
+std::string Converter::CreateArt(BrightnessPyramid* pyramid, size_t chunk_size) {
+
+    if (NULL == pyramid) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    const ChunkPlan& plan = GetPlan(pyramid->GetSizeX(), pyramid->GetSizeY(), chunk_size);
+    const ChunkGrid& grid = plan.GetGrid();
+    const msize_t x_nof_chunks = grid.GetXChunks();
+    const msize_t y_nof_chunks = grid.GetYChunks();
+    const msize_t y_chunk_size = grid.GetChunkYSize();
+
+    const std::vector<msize_t>& column_bounds = plan.GetColumnBounds();
+    const std::vector<msize_t>& row_bounds = plan.GetRowBounds();
+    msize_t x_cells = plan.GetXCells();
+    msize_t y_cells = plan.GetYCells();
+
+    // the coarsest level where the smallest sub-cell still covers a whole sample
+    msize_t min_cell = std::min<msize_t>(chunk_size, y_chunk_size);
+    for (msize_t cell = 0; cell < x_cells; cell++) {
+        min_cell = std::min(min_cell, column_bounds[cell + 1] - column_bounds[cell]);
+    }
+    for (msize_t cell = 0; cell < y_cells; cell++) {
+        min_cell = std::min(min_cell, row_bounds[cell + 1] - row_bounds[cell]);
+    }
+
+    msize_t level = 0;
+    while (level + 1 < pyramid->GetLevelsCount() && ((msize_t)2 << level) <= min_cell) {
+        level++;
+    }
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix = pyramid->GetLevel(level);
+
+    msize_t x_margin = plan.GetXMargin();
+    msize_t y_margin = plan.GetYMargin();
+
+    uint8_t threshold = 0;
+    bool binary = _chunk_conv->pixelThreshold(threshold);
+
+    Matrix<unsigned long> sums(x_nof_chunks * x_cells, y_nof_chunks * y_cells);
+
+    for (msize_t i = y_margin; i + y_margin < y_nof_chunks; i++) {
+        for (msize_t cell_row = 0; cell_row < y_cells; cell_row++) {
+            unsigned long* sums_row = sums[i * y_cells + cell_row].data();
+            msize_t y_start = grid.GetYOrigin() + i * y_chunk_size + row_bounds[cell_row];
+            msize_t y_end = grid.GetYOrigin() + i * y_chunk_size + row_bounds[cell_row + 1];
+
+            for (msize_t j = x_margin; j + x_margin < x_nof_chunks; j++) {
+                for (msize_t cell_column = 0; cell_column < x_cells; cell_column++) {
+                    msize_t x_start = grid.GetXOrigin() + j * chunk_size + column_bounds[cell_column];
+                    msize_t x_end = grid.GetXOrigin() + j * chunk_size + column_bounds[cell_column + 1];
+                    unsigned long sum = 0;
+
+                    for (msize_t ly = y_start >> level; ly < y_end >> level; ly++) {
+                        const uint8_t* row = (*brightness_matrix)[ly].data();
+                        for (msize_t lx = x_start >> level; lx < x_end >> level; lx++) {
+                            sum += binary ? (row[lx] > threshold) : row[lx];
+                        }
+                    }
+
+                    unsigned long samples = (unsigned long)((x_end >> level) - (x_start >> level)) * ((y_end >> level) - (y_start >> level));
+                    unsigned long area = (unsigned long)(x_end - x_start) * (y_end - y_start);
+                    sums_row[j * x_cells + cell_column] = (sum * area + samples / 2) / samples;
+                }
+            }
+        }
+    }
+
+    std::string art;
+    _chunk_conv->convertSums(&sums, column_bounds, row_bounds, art);
     return art;
 }
+
+/**
+ * @brief Computes the statistics of every chunk of the image using the specified chunk size.
+ *        Brightness is converted for the chunk grid and the one pixel border the gradients read.
+ *
+ * @param img The image to compute the statistics of.
+ * @param chunk_size The size of each chunk.
+ * @return The chunk statistics.
+ * @throw std::error_code if the image is null or the chunk size is 0 or bigger than the image.
+ */
+ChunkStats Converter::CreateStats(Image* img, size_t chunk_size) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    const ChunkGrid& grid = GetPlan(img->GetSizeX(), img->GetSizeY(), chunk_size).GetGrid();
+    Region region = grid.GetRegion();
+    region = {region.X_start_index > 0 ? region.X_start_index - 1 : 0, std::min(region.X_end_index + 1, img->GetSizeX()),
+              region.Y_start_index > 0 ? region.Y_start_index - 1 : 0, std::min(region.Y_end_index + 1, img->GetSizeY())};
+
+    std::shared_ptr<Matrix<uint8_t>> brightness_m = _brightness_conv->convertRegion(img, region);
+
+    if (NULL == brightness_m) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    return ChunkStats(grid, brightness_m.get());
+}
@@ -8,6 +8,12 @@
 
 using namespace AAC;
 
+// raw row access relies on pixels being stored as packed components
+static_assert(sizeof(Pixel<Pixel_Type::G>) == 1, "Pixel<G> must be packed");
+static_assert(sizeof(Pixel<Pixel_Type::GA>) == 2, "Pixel<GA> must be packed");
+static_assert(sizeof(Pixel<Pixel_Type::RGB>) == 3, "Pixel<RGB> must be packed");
+static_assert(sizeof(Pixel<Pixel_Type::RGBA>) == 4, "Pixel<RGBA> must be packed");
+
 /**
  * @brief Refactors the input data into a matrix of Pixel<G> elements.
  * @param size_x The size of the matrix in the x-axis.
@@ -225,3 +231,34 @@ msize_t Image::GetSizeY() const {
 Pixel_Type Image::GetPixelType() const {
     return _pixel_type;
 }
+
+/**
+ * @brief Getter for the number of color components per pixel.
+ * 
+ * @return the number of components.
+ */
+uint8_t Image::GetChannels() const {
+    return _n;
+}
+
+/**
+ * @brief Gets raw pixel components of the given row. Components are stored
+ *        interleaved, GetChannels() values per pixel.
+ * 
+ * @param y The row index.
+ * @return Pointer to the first component of the row.
+ */
+const uint8_t* Image::GetRawRow(msize_t y) {
+    switch (_pixel_type) {
+        case Pixel_Type::G:
+            return reinterpret_cast<const uint8_t*>((*reinterpret_cast<Matrix<Pixel<Pixel_Type::G>> *>(_pixels_matrix))[y].data());
+        case Pixel_Type::GA:
+            return reinterpret_cast<const uint8_t*>((*reinterpret_cast<Matrix<Pixel<Pixel_Type::GA>> *>(_pixels_matrix))[y].data());
+        case Pixel_Type::RGB:
+            return reinterpret_cast<const uint8_t*>((*reinterpret_cast<Matrix<Pixel<Pixel_Type::RGB>> *>(_pixels_matrix))[y].data());
+        case Pixel_Type::RGBA:
+            return reinterpret_cast<const uint8_t*>((*reinterpret_cast<Matrix<Pixel<Pixel_Type::RGBA>> *>(_pixels_matrix))[y].data());
+        default:
+            throw AACException(error_codes::INVALID_PIXEL);
+    }
+}
@@ -0,0 +1,124 @@
+/**
+ * @file aac_parallel.tpp
+ * @brief Contains the implementation of the parallel utilities.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Resolves the number of worker threads to use for the given amount of work.
+ * @param threads Requested number of threads (0 means hardware concurrency).
+ * @param work Number of independent work items (rows, tiles...).
+ * @return Number of threads, never bigger than the amount of work and at least 1.
+ */
+inline unsigned ResolveThreads(unsigned threads, msize_t work) {
+    if (0 == threads) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (0 == threads) {
+        threads = 1;
+    }
+    if (work < threads) {
+        threads = (0 == work) ? 1 : (unsigned)work;
+    }
+    return threads;
+}
+
+template <typename F>
+/**
+ * @brief Splits [begin, end) into contiguous bands and runs body(band, band_begin, band_end) for every band.
+ *        The first band is executed on the calling thread. An exception thrown by a band is rethrown
+ *        on the calling thread once every band has finished.
+ * @param begin First index of the range (inclusive).
+ * @param end Last index of the range (exclusive).
+ * @param threads Requested number of threads (0 means hardware concurrency).
+ * @param body Callable invoked once per band.
+ * @return Number of bands the range was split into.
+ */
+unsigned ParallelBands(msize_t begin, msize_t end, unsigned threads, F&& body) {
+    msize_t work = (end > begin) ? end - begin : 0;
+    unsigned bands = ResolveThreads(threads, work);
+
+    if (1 == bands) {
+        body(0u, begin, end);
+        return 1;
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(bands);
+    workers.reserve(bands - 1);
+
+    for (unsigned band = 1; band < bands; band++) {
+        msize_t band_begin = begin + work * band / bands;
+        msize_t band_end = begin + work * (band + 1) / bands;
+        workers.emplace_back([&body, &errors, band, band_begin, band_end]() {
+            try {
+                body(band, band_begin, band_end);
+            }
+            catch (...) {
+                errors[band] = std::current_exception();
+            }
+        });
+    }
+
+    try {
+        body(0u, begin, begin + work / bands);
+    }
+    catch (...) {
+        errors[0] = std::current_exception();
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return bands;
+}
+
+template <typename F>
+/**
+ * @brief Runs body(tile) for every tile in [0, tiles) with work stealing between the workers. Every
+ *        worker starts on its own contiguous range of tiles and, once it runs dry, steals the remaining
+ *        tiles of the other workers, so uneven tiles balance out. Workers are threads started for the
+ *        call by ParallelBands (the calling thread is one of them), there is no persistent pool.
+ * @param tiles Number of tiles.
+ * @param threads Requested number of threads (0 means hardware concurrency).
+ * @param body Callable invoked once per tile.
+ * @return Number of workers the tiles were run on.
+ */
+unsigned ParallelTiles(msize_t tiles, unsigned threads, F&& body) {
+    unsigned workers = ResolveThreads(threads, tiles);
+
+    if (1 == workers) {
+        for (msize_t tile = 0; tile < tiles; tile++) {
+            body(tile);
+        }
+        return 1;
+    }
+
+    // next unclaimed tile and the end of every worker's range
+    std::vector<std::atomic<msize_t>> next(workers);
+    std::vector<msize_t> ends(workers);
+    for (unsigned worker = 0; worker < workers; worker++) {
+        next[worker].store(tiles * worker / workers, std::memory_order_relaxed);
+        ends[worker] = tiles * (worker + 1) / workers;
+    }
+
+    ParallelBands(0, workers, workers, [&](unsigned worker, msize_t, msize_t) {
+        for (unsigned offset = 0; offset < workers; offset++) {
+            unsigned victim = (worker + offset) % workers;
+            for (msize_t tile = next[victim].fetch_add(1, std::memory_order_relaxed); tile < ends[victim];
+                 tile = next[victim].fetch_add(1, std::memory_order_relaxed)) {
+                body(tile);
+            }
+        }
+    });
+
+    return workers;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file aac_static_matrix.tpp
+ * @brief Contains the implementation of the StaticMatrix class.
+ */
+
+using namespace AAC;
+
+template <typename T, msize_t W, msize_t H>
+/**
+ * @brief Constructs a StaticMatrix object with value initialized cells.
+ */
+constexpr StaticMatrix<T, W, H>::StaticMatrix() : _cells{} { }
+
+template <typename T, msize_t W, msize_t H>
+/**
+ * @brief Constructs a StaticMatrix object with every cell set to the given value.
+ * @param value The value of the cells.
+ */
+constexpr StaticMatrix<T, W, H>::StaticMatrix(const T& value) : _cells{}
+{
+    Fill(value);
+}
+
+template <typename T, msize_t W, msize_t H>
+/**
+ * @brief Gets the size in the x-axis.
+ * @return The number of columns.
+ */
+constexpr msize_t StaticMatrix<T, W, H>::GetXSize()
+{
+    return W;
+}
+
+template <typename T, msize_t W, msize_t H>
+/**
+ * @brief Gets the size in the y-axis.
+ * @return The number of rows.
+ */
+constexpr msize_t StaticMatrix<T, W, H>::GetYSize()
+{
+    return H;
+}
+
+template <typename T, msize_t W, msize_t H>
+/**
+ * @brief Accesses a row of the matrix. Indices are not checked.
+ * @param index The row index.
+ * @return A pointer to the first cell of the row.
+ */
+constexpr T* StaticMatrix<T, W, H>::operator[](msize_t index)
+{
+    return _cells[index];
+}
+
+template <typename T, msize_t W, msize_t H>
+/**
+ * @brief Accesses a row of the matrix. Indices are not checked.
+ * @param index The row index.
+ * @return A pointer to the first cell of the row.
+ */
+constexpr const T* StaticMatrix<T, W, H>::operator[](msize_t index) const
+{
+    return _cells[index];
+}
+
+template <typename T, msize_t W, msize_t H>
+/**
+ * @brief Sets every cell to the given value.
+ * @param value The value of the cells.
+ */
+constexpr void StaticMatrix<T, W, H>::Fill(const T& value)
+{
+    for( msize_t row = 0; row < H; row++ ) {
+        for( msize_t column = 0; column < W; column++ ) {
+            _cells[row][column] = value;
+        }
+    }
+}
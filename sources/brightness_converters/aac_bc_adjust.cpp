@@ -0,0 +1,178 @@
+#include <aac.h>
+
+/**
+ * @file aac_bc_adjust.cpp
+ * @brief Contains the implementation of the AAC::BC_Adjust class.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Constructs a new BC_Adjust object without adjustments.
+ *        Weights have the BC_Simple meaning, so channels are weighted by weight / 3.
+ *
+ * @param red_weight The weight for the red channel.
+ * @param green_weight The weight for the green channel.
+ * @param blue_weight The weight for the blue channel.
+ *
+ * @throws error_code An exception is thrown if the weights are negative.
+ */
+BC_Adjust::BC_Adjust(float red_weight, float green_weight, float blue_weight) {
+
+    if (red_weight < 0 || green_weight < 0 || blue_weight < 0) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _red_weight = FixedWeight(red_weight);
+    _green_weight = FixedWeight(green_weight);
+    _blue_weight = FixedWeight(blue_weight);
+
+    for (unsigned level = 0; level < 256; level++) {
+        _lut[level] = (uint8_t)level;
+    }
+}
+
+template <typename ValueStage>
+/**
+ * @brief Appends a value stage to the chain by mapping the current table through it.
+ *
+ * @param stage The value stage.
+ * @return Reference to this converter.
+ */
+BC_Adjust& BC_Adjust::compose(const ValueStage& stage) {
+    for (unsigned level = 0; level < 256; level++) {
+        _lut[level] = stage.Apply(_lut[level]);
+    }
+    return *this;
+}
+
+/**
+ * @brief Appends a gamma curve to the chain.
+ *
+ * @param gamma The gamma exponent (values above 1 darken the image).
+ * @return Reference to this converter.
+ *
+ * @throws error_code An exception is thrown if the exponent is not positive.
+ */
+BC_Adjust& BC_Adjust::AddGamma(float gamma) {
+    return compose(Stage::Gamma(gamma));
+}
+
+/**
+ * @brief Appends a contrast change to the chain.
+ *
+ * @param factor The contrast factor (values above 1 increase the contrast).
+ * @param pivot The brightness level left unchanged.
+ * @return Reference to this converter.
+ */
+BC_Adjust& BC_Adjust::AddContrast(float factor, float pivot) {
+    return compose(Stage::Contrast(factor, pivot));
+}
+
+/**
+ * @brief Appends a saturating brightness offset to the chain.
+ *
+ * @param offset The offset.
+ * @return Reference to this converter.
+ */
+BC_Adjust& BC_Adjust::AddBrightness(int offset) {
+    return compose(Stage::Brightness(offset));
+}
+
+/**
+ * @brief Appends negation to the chain.
+ *
+ * @return Reference to this converter.
+ */
+BC_Adjust& BC_Adjust::AddNegate() {
+    return compose(Stage::Negate());
+}
+
+/**
+ * @brief Appends clamping into a range to the chain.
+ *
+ * @param low The lowest allowed brightness.
+ * @param high The highest allowed brightness.
+ * @return Reference to this converter.
+ *
+ * @throws error_code An exception is thrown if the range is empty.
+ */
+BC_Adjust& BC_Adjust::AddClamp(uint8_t low, uint8_t high) {
+    return compose(Stage::Clamp(low, high));
+}
+
+/**
+ * @brief Converts the given image to an adjusted brightness matrix.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the image is null or the pixel type is invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Adjust::convert(Image* img) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    return convertRegion(img, {0, img->GetSizeX(), 0, img->GetSizeY()});
+}
+
+/**
+ * @brief Converts the given region of the image to a brightness matrix of the image size.
+ *        Pixels outside the region are left at zero.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which brightness is needed.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the image is null or the pixel type is invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Adjust::convertRegion(Image* img, const Region& region) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix(new Matrix<uint8_t>(img->GetSizeX(), img->GetSizeY()));
+
+    for (msize_t y = region.Y_start_index; y < region.Y_end_index; y++) {
+        convertRow(img, y, region.X_start_index, region.X_end_index, (*brightness_matrix)[y].data());
+    }
+
+    return brightness_matrix;
+}
+
+/**
+ * @brief Tells if the converter can compute brightness row by row.
+ *
+ * @return Always true.
+ */
+bool BC_Adjust::SupportsRows() const {
+    return true;
+}
+
+/**
+ * @brief Tells if the brightness of every pixel depends on that pixel alone.
+ *
+ * @return Always true.
+ */
+bool BC_Adjust::IsPixelLocal() const {
+    return true;
+}
+
+/**
+ * @brief Computes adjusted brightness of a part of a single image row. The weighting and the
+ *        composed table run in the same loop, so the cost does not depend on the chain length.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param y The row index.
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param row Output row, indexed with image x coordinates.
+ *
+ * @throws error_code An exception is thrown if the pixel type is invalid.
+ */
+void BC_Adjust::convertRow(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index, uint8_t* row) {
+    WeightRowLut(img, y, X_start_index, X_end_index, _red_weight, _green_weight, _blue_weight, _lut, row);
+}
@@ -0,0 +1,174 @@
+#include <aac.h>
+
+/**
+ * @file aac_bc_auto_levels.cpp
+ * @brief Contains the implementation of the AAC::BC_AutoLevels class.
+ */
+
+using namespace AAC;
+
+#define AUTO_LEVELS_BINS 256
+
+/**
+ * @brief Constructs a new BC_AutoLevels object.
+ *        Weights have the BC_Simple meaning, so channels are weighted by weight / 3.
+ *
+ * @param red_weight The weight for the red channel.
+ * @param green_weight The weight for the green channel.
+ * @param blue_weight The weight for the blue channel.
+ * @param low_percentile Percentile of the brightness mapped to 0.
+ * @param high_percentile Percentile of the brightness mapped to 255.
+ * @param stride Distance between sampled pixels in both axes (1 samples every pixel).
+ *
+ * @throws error_code An exception is thrown if the weights are negative, percentiles are not
+ *                    an increasing pair in range 0 - 100 or the stride is 0.
+ */
+BC_AutoLevels::BC_AutoLevels(float red_weight, float green_weight, float blue_weight, float low_percentile, float high_percentile, msize_t stride) :
+    _low_percentile(low_percentile), _high_percentile(high_percentile), _stride(stride) {
+
+    if (red_weight < 0 || green_weight < 0 || blue_weight < 0 || 0 == stride ||
+        !(0 <= low_percentile && low_percentile < high_percentile && high_percentile <= 100)) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _red_weight = FixedWeight(red_weight);
+    _green_weight = FixedWeight(green_weight);
+    _blue_weight = FixedWeight(blue_weight);
+
+    for (unsigned level = 0; level < AUTO_LEVELS_BINS; level++) {
+        _lut[level] = (uint8_t)level;
+    }
+}
+
+/**
+ * @brief Converts the given image to a brightness matrix stretched between the percentiles.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the image is null or the pixel type is invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_AutoLevels::convert(Image* img) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    return convertRegion(img, {0, img->GetSizeX(), 0, img->GetSizeY()});
+}
+
+/**
+ * @brief Converts the given region of the image to a brightness matrix of the image size.
+ *        Levels are measured on the region only, pixels outside it are left at zero.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which brightness is needed.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the image is null or the pixel type is invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_AutoLevels::convertRegion(Image* img, const Region& region) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    prepareRows(img, region);
+
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix(new Matrix<uint8_t>(img->GetSizeX(), img->GetSizeY()));
+
+    for (msize_t y = region.Y_start_index; y < region.Y_end_index; y++) {
+        convertRow(img, y, region.X_start_index, region.X_end_index, (*brightness_matrix)[y].data());
+    }
+
+    return brightness_matrix;
+}
+
+/**
+ * @brief Tells if the converter can compute brightness row by row.
+ *
+ * @return Always true.
+ */
+bool BC_AutoLevels::SupportsRows() const {
+    return true;
+}
+
+/**
+ * @brief Measures the levels of the given region of the image. Every stride-th pixel of every
+ *        stride-th row is weighted into a histogram, the percentiles are read from its cumulative
+ *        distribution and the stretch between them is stored as a lookup table.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which rows are going to be converted.
+ *
+ * @throws error_code An exception is thrown if the pixel type is invalid.
+ */
+void BC_AutoLevels::prepareRows(Image* img, const Region& region) {
+
+    Pixel_Type pixel_type = img->GetPixelType();
+    if (Pixel_Type::G != pixel_type && Pixel_Type::GA != pixel_type && Pixel_Type::RGB != pixel_type && Pixel_Type::RGBA != pixel_type) {
+        throw AACException(error_codes::INVALID_PIXEL);
+    }
+
+    const msize_t channels = img->GetChannels();
+    unsigned long histogram[AUTO_LEVELS_BINS] = {0};
+    unsigned long samples = 0;
+
+    for (msize_t y = region.Y_start_index; y < region.Y_end_index; y += _stride) {
+        const uint8_t* src = img->GetRawRow(y);
+        for (msize_t x = region.X_start_index; x < region.X_end_index; x += _stride) {
+            histogram[WeightPixel(&src[x * channels], pixel_type, _red_weight, _green_weight, _blue_weight)]++;
+            samples++;
+        }
+    }
+
+    // percentile levels are the first bins reaching the requested share of samples
+    unsigned long low_count = (unsigned long)std::ceil(samples * _low_percentile / 100);
+    unsigned long high_count = (unsigned long)std::ceil(samples * _high_percentile / 100);
+    unsigned low = 0, high = AUTO_LEVELS_BINS - 1;
+    unsigned long cumulative = 0;
+    bool low_found = false;
+
+    for (unsigned bin = 0; bin < AUTO_LEVELS_BINS; bin++) {
+        cumulative += histogram[bin];
+        if (!low_found && cumulative >= low_count && cumulative > 0) {
+            low = bin;
+            low_found = true;
+        }
+        if (cumulative >= high_count && cumulative > 0) {
+            high = bin;
+            break;
+        }
+    }
+
+    for (unsigned level = 0; level < AUTO_LEVELS_BINS; level++) {
+        if (high <= low) {
+            _lut[level] = (uint8_t)level;
+        }
+        else if (level <= low) {
+            _lut[level] = 0;
+        }
+        else if (level >= high) {
+            _lut[level] = 255;
+        }
+        else {
+            _lut[level] = (uint8_t)(((level - low) * 255 + (high - low) / 2) / (high - low));
+        }
+    }
+}
+
+/**
+ * @brief Computes stretched brightness of a part of a single image row. The weighting and the
+ *        stretch table run in the same loop, the pixel type is resolved once per row.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param y The row index.
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param row Output row, indexed with image x coordinates.
+ *
+ * @throws error_code An exception is thrown if the pixel type is invalid.
+ */
+void BC_AutoLevels::convertRow(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index, uint8_t* row) {
+    WeightRowLut(img, y, X_start_index, X_end_index, _red_weight, _green_weight, _blue_weight, _lut, row);
+}
@@ -0,0 +1,105 @@
+/**
+ * @file aac_bc_bands.h
+ * @brief Internal helper for in-place vertical window filters processed in parallel row bands.
+ */
+
+#ifndef AAC_BC_BANDS_H
+#define AAC_BC_BANDS_H
+
+#include <aac.h>
+
+namespace AAC {
+
+template <typename T, typename Load, typename Emit>
+/**
+ * @brief Runs a vertical window filter over the rows of a region of the matrix in place, split into
+ *        parallel row bands.
+ *
+ * Every band keeps a rolling buffer of 2 * radius + 1 loaded rows, so the only extra memory is the
+ * rolling buffer and the radius rows above and below every band which are copied before any band
+ * starts writing. Rows outside the image are replicated from the border rows, rows outside the region
+ * are read as they are, so the caller has to provide them. Only the region columns have to be handled
+ * by load and emit.
+ *
+ * @param matrix The matrix filtered in place.
+ * @param region The region written by the filter.
+ * @param radius Number of rows above and below needed to produce an output row.
+ * @param row_width Number of T elements in a loaded row.
+ * @param threads Requested number of threads (0 means hardware concurrency).
+ * @param load Callable load(const uint8_t* src_row, T* loaded_row) preparing a source row (e.g. horizontal pass).
+ * @param emit Callable emit(const T* const* window, msize_t y, uint8_t* dst_row) producing output row y
+ *             from the loaded rows y - radius ... y + radius.
+ */
+void FilterRowBands(Matrix<uint8_t>& matrix, const Region& region, msize_t radius, msize_t row_width, unsigned threads, Load&& load, Emit&& emit) {
+    msize_t size_x = matrix.GetXSize();
+    msize_t size_y = matrix.GetYSize();
+
+    msize_t y_start = region.Y_start_index;
+    msize_t y_end = region.Y_end_index;
+
+    if (0 == size_x || 0 == size_y || y_start >= y_end || region.X_start_index >= region.X_end_index) {
+        return;
+    }
+
+    // copy band halos before any band overwrites its rows (same split as ParallelBands)
+    msize_t work = y_end - y_start;
+    unsigned bands = ResolveThreads(threads, work);
+    std::vector<std::vector<uint8_t>> above(bands), below(bands);
+
+    auto clamped_row = [&](long y) -> const std::vector<uint8_t>& {
+        y = std::max(0l, std::min((long)size_y - 1, y));
+        return matrix[y];
+    };
+
+    for (unsigned band = 0; band < bands; band++) {
+        long band_start = y_start + work * band / bands;
+        long band_end = y_start + work * (band + 1) / bands;
+        above[band].resize(radius * size_x);
+        below[band].resize(radius * size_x);
+
+        for (msize_t i = 0; i < radius; i++) {
+            std::copy_n(clamped_row(band_start - (long)radius + (long)i).data(), size_x, &above[band][i * size_x]);
+            std::copy_n(clamped_row(band_end + (long)i).data(), size_x, &below[band][i * size_x]);
+        }
+    }
+
+    ParallelBands(y_start, y_end, threads, [&](unsigned band, msize_t band_start, msize_t band_end) {
+        msize_t window_size = 2 * radius + 1;
+        std::vector<T> ring(window_size * row_width);
+        std::vector<const T*> window(window_size);
+
+        // j indexes rows relative to band_start - radius
+        auto load_row = [&](msize_t j) {
+            const uint8_t* src;
+            if (j < radius) {
+                src = &above[band][j * size_x];
+            }
+            else if (j - radius >= band_end - band_start) {
+                src = &below[band][(j - radius - (band_end - band_start)) * size_x];
+            }
+            else {
+                src = matrix[band_start + j - radius].data();
+            }
+            load(src, &ring[(j % window_size) * row_width]);
+        };
+
+        for (msize_t j = 0; j < 2 * radius; j++) {
+            load_row(j);
+        }
+
+        for (msize_t y = band_start; y < band_end; y++) {
+            msize_t j = y - band_start;
+            load_row(j + 2 * radius);
+
+            for (msize_t i = 0; i < window_size; i++) {
+                window[i] = &ring[((j + i) % window_size) * row_width];
+            }
+
+            emit(window.data(), y, matrix[y].data());
+        }
+    });
+}
+
+} // namespace AAC
+
+#endif // AAC_BC_BANDS_H
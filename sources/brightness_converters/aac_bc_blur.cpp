@@ -0,0 +1,91 @@
+#include <aac.h>
+
+#include "aac_bc_blur.h"
+
+/**
+ * @file aac_bc_blur.cpp
+ * @brief Contains the implementation of the AAC::BC_Blur class.
+ */
+
+using namespace AAC;
+
+#define BLUR_MAX_GAUSSIAN_RADIUS 8
+
+/**
+ * @brief Constructs a new BC_Blur object. The Gaussian kernel is approximated by binomial
+ *        coefficients of order 2 * radius, so its weights sum up to a power of two.
+ *
+ * @param source The brightness converter which output is blurred.
+ * @param kernel Blur kernel (box or Gaussian).
+ * @param radius Kernel radius, the kernel spans 2 * radius + 1 pixels in both axes.
+ * @param threads Number of threads used for the row bands (0 means hardware concurrency).
+ *
+ * @throws error_code An exception is thrown if the Gaussian radius is bigger than 8.
+ */
+BC_Blur::BC_Blur(BrightnessConverter* source, BlurKernel kernel, msize_t radius, unsigned threads) :
+    _source(source), _kernel(kernel), _radius(radius), _threads(threads) {
+
+    if (BlurKernel::GAUSSIAN == kernel) {
+        if (radius > BLUR_MAX_GAUSSIAN_RADIUS) {
+            throw AACException(error_codes::INVALID_ARGUMENTS);
+        }
+
+        _weights = BinomialWeights(radius);
+    }
+}
+
+/**
+ * @brief Converts the given image with the source converter and blurs the result.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the source converter or image is null.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Blur::convert(Image* img) {
+
+    if (NULL == _source || NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    return convertRegion(img, {0, img->GetSizeX(), 0, img->GetSizeY()});
+}
+
+/**
+ * @brief Converts the given region of the image with the source converter and blurs it in place.
+ *        Every row gets a horizontal pass (running sum for the box kernel) kept in a rolling buffer
+ *        of 2 * radius + 1 rows which are combined vertically, so no full size buffer is allocated.
+ *        The source converter is asked for the region grown by the kernel radius, border pixels of
+ *        the image are replicated.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which brightness is needed.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the source converter or image is null.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Blur::convertRegion(Image* img, const Region& region) {
+
+    if (NULL == _source || NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    msize_t size_x = img->GetSizeX();
+    msize_t size_y = img->GetSizeY();
+    msize_t x_start = region.X_start_index;
+    msize_t x_end = region.X_end_index;
+    const msize_t radius = _radius;
+
+    Region source_region = {x_start > radius ? x_start - radius : 0, std::min(x_end + radius, size_x),
+                            region.Y_start_index > radius ? region.Y_start_index - radius : 0, std::min(region.Y_end_index + radius, size_y)};
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix = _source->convertRegion(img, source_region);
+
+    if (0 == radius || 0 == size_x || 0 == size_y || x_start >= x_end) {
+        return brightness_matrix;
+    }
+
+    BlurRowBands(*brightness_matrix, region, _kernel, radius, _weights, _threads,
+                 [](uint8_t, uint8_t blurred) { return blurred; });
+
+    return brightness_matrix;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file aac_bc_blur.h
+ * @brief Internal helpers for separable blur passes shared by the blurring brightness converters.
+ */
+
+#ifndef AAC_BC_BLUR_H
+#define AAC_BC_BLUR_H
+
+#include <aac.h>
+
+#include "aac_bc_bands.h"
+
+namespace AAC {
+
+/**
+ * @brief Gets the binomial weights of order 2 * radius approximating a Gaussian kernel.
+ *        The weights sum up to 4 ^ radius.
+ *
+ * @param radius Kernel radius.
+ * @return 2 * radius + 1 weights.
+ */
+inline std::vector<uint32_t> BinomialWeights(msize_t radius) {
+    std::vector<uint32_t> weights(2 * radius + 1, 0);
+    weights[0] = 1;
+    for (msize_t order = 1; order <= 2 * radius; order++) {
+        for (msize_t k = order; k > 0; k--) {
+            weights[k] += weights[k - 1];
+        }
+    }
+    return weights;
+}
+
+template <typename Combine>
+/**
+ * @brief Blurs a region of the matrix in place with a separable kernel and parallel row bands.
+ *        Every row gets a horizontal pass (running sum for the box kernel) kept in the rolling
+ *        buffer of FilterRowBands, rows are combined vertically. Border pixels of the image are
+ *        replicated, rows and columns outside the region within the radius are read.
+ *
+ * @param matrix The matrix filtered in place.
+ * @param region The region written by the filter.
+ * @param kernel Blur kernel.
+ * @param radius Kernel radius (not 0).
+ * @param weights Binomial weights for the Gaussian kernel (see BinomialWeights).
+ * @param threads Requested number of threads (0 means hardware concurrency).
+ * @param combine Callable combine(uint8_t original, uint8_t blurred) giving the output pixel.
+ */
+void BlurRowBands(Matrix<uint8_t>& matrix, const Region& region, BlurKernel kernel, msize_t radius,
+                  const std::vector<uint32_t>& weights, unsigned threads, Combine&& combine) {
+    const msize_t size_x = matrix.GetXSize();
+    const msize_t x_start = region.X_start_index;
+    const msize_t x_end = region.X_end_index;
+
+    auto clamped = [&](long x) { return (msize_t)std::max(0l, std::min((long)size_x - 1, x)); };
+
+    if (BlurKernel::BOX == kernel) {
+        const uint64_t norm = (uint64_t)(2 * radius + 1) * (2 * radius + 1);
+
+        // horizontal running sum
+        auto load = [&](const uint8_t* src, uint32_t* loaded) {
+            uint32_t sum = 0;
+            for (long k = -(long)radius; k <= (long)radius; k++) {
+                sum += src[clamped((long)x_start + k)];
+            }
+            loaded[x_start] = sum;
+            for (msize_t x = x_start + 1; x < x_end; x++) {
+                sum += src[clamped((long)(x + radius))] - src[clamped((long)x - 1 - (long)radius)];
+                loaded[x] = sum;
+            }
+        };
+
+        auto emit = [&](const uint32_t* const* window, msize_t, uint8_t* dst) {
+            for (msize_t x = x_start; x < x_end; x++) {
+                uint64_t sum = 0;
+                for (msize_t i = 0; i <= 2 * radius; i++) {
+                    sum += window[i][x];
+                }
+                dst[x] = combine(dst[x], (uint8_t)((sum + norm / 2) / norm));
+            }
+        };
+
+        FilterRowBands<uint32_t>(matrix, region, radius, size_x, threads, load, emit);
+    }
+    else {
+        const unsigned norm_shift = 4 * radius;
+        const uint32_t* taps_weights = weights.data();
+
+        auto load = [&](const uint8_t* src, uint32_t* loaded) {
+            // interior pixels need no clamping
+            for (msize_t x = x_start; x < x_end; x++) {
+                uint32_t sum = 0;
+                if (x >= radius && x + radius < size_x) {
+                    const uint8_t* taps = src + x - radius;
+                    for (msize_t k = 0; k <= 2 * radius; k++) {
+                        sum += taps_weights[k] * taps[k];
+                    }
+                }
+                else {
+                    for (msize_t k = 0; k <= 2 * radius; k++) {
+                        sum += taps_weights[k] * src[clamped((long)(x + k) - (long)radius)];
+                    }
+                }
+                loaded[x] = sum;
+            }
+        };
+
+        auto emit = [&](const uint32_t* const* window, msize_t, uint8_t* dst) {
+            for (msize_t x = x_start; x < x_end; x++) {
+                uint64_t sum = 0;
+                for (msize_t i = 0; i <= 2 * radius; i++) {
+                    sum += (uint64_t)taps_weights[i] * window[i][x];
+                }
+                dst[x] = combine(dst[x], (uint8_t)((sum + (1ull << (norm_shift - 1))) >> norm_shift));
+            }
+        };
+
+        FilterRowBands<uint32_t>(matrix, region, radius, size_x, threads, load, emit);
+    }
+}
+
+} // namespace AAC
+
+#endif // AAC_BC_BLUR_H
@@ -0,0 +1,231 @@
+#include <aac.h>
+
+#include <algorithm>
+
+/**
+ * @file aac_bc_clahe.cpp
+ * @brief Contains the implementation of the AAC::BC_CLAHE class.
+ */
+
+using namespace AAC;
+
+#define CLAHE_BINS 256
+#define CLAHE_WEIGHT_SHIFT 8
+#define CLAHE_WEIGHT_ONE (1 << CLAHE_WEIGHT_SHIFT)
+
+/**
+ * @brief Constructs a new BC_CLAHE object with a uniform tile grid.
+ *
+ * @param source The brightness converter which output is equalized.
+ * @param tiles_x Number of tiles in the x-axis.
+ * @param tiles_y Number of tiles in the y-axis.
+ * @param clip_limit Histogram clip limit as a multiple of the average bin height (0 disables clipping).
+ * @param threads Number of threads used for the tile and blend passes (0 means hardware concurrency).
+ */
+BC_CLAHE::BC_CLAHE(BrightnessConverter* source, msize_t tiles_x, msize_t tiles_y, float clip_limit, unsigned threads) :
+    _source(source), _tiles_x(tiles_x), _tiles_y(tiles_y), _chunk_size(0), _chunks_per_tile(0), _ratio(DEFAULT_FONT_RATIO), _clip_limit(clip_limit), _threads(threads) {}
+
+/**
+ * @brief Aligns the tile grid with the Converter chunk grid. Every tile then covers
+ *        chunks_per_tile x chunks_per_tile chunks, the cut margins are merged into the border tiles.
+ *
+ * @param chunk_size The chunk size that will be passed to Converter::CreateArt.
+ * @param chunks_per_tile Number of chunks covered by a tile along each axis (0 restores the uniform grid).
+ * @param ratio The font width to height ratio of the Converter.
+ *
+ * @throws error_code An exception is thrown if the ratio is not positive.
+ */
+void BC_CLAHE::AlignToChunks(size_t chunk_size, msize_t chunks_per_tile, float ratio) {
+
+    if (!(ratio > 0)) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _chunk_size = chunk_size;
+    _chunks_per_tile = chunks_per_tile;
+    _ratio = ratio;
+}
+
+/**
+ * @brief Calculates tile boundaries along one axis.
+ *
+ * @param size Size of the axis.
+ * @param origin Start of the first aligned tile (ignored for uniform grid).
+ * @param tile_size Size of an aligned tile, 0 splits the axis uniformly.
+ * @param tiles Number of tiles.
+ * @param bounds Output boundaries (tiles + 1 values, first is 0 and last is size).
+ */
+void BC_CLAHE::tileBounds(msize_t size, msize_t origin, msize_t tile_size, msize_t tiles, std::vector<msize_t>& bounds) const {
+    bounds.resize(tiles + 1);
+    for (msize_t i = 0; i <= tiles; i++) {
+        bounds[i] = (0 == tile_size) ? size * i / tiles : origin + i * tile_size;
+    }
+    bounds[0] = 0;
+    bounds[tiles] = size;
+}
+
+/**
+ * @brief Precomputes bilinear interpolation parameters for every position along one axis.
+ *
+ * @param bounds Tile boundaries along the axis.
+ * @param size Size of the axis.
+ * @param first Output index of the first tile to blend.
+ * @param second Output index of the second tile to blend.
+ * @param weight Output fixed point weight of the second tile.
+ */
+static void axisBlend(const std::vector<msize_t>& bounds, msize_t size, std::vector<msize_t>& first, std::vector<msize_t>& second, std::vector<uint16_t>& weight) {
+    msize_t tiles = bounds.size() - 1;
+    first.resize(size);
+    second.resize(size);
+    weight.resize(size);
+
+    // doubled coordinates keep tile centers integral
+    msize_t tile = 0;
+    for (msize_t p = 0; p < size; p++) {
+        msize_t p2 = 2 * p + 1;
+
+        while (tile + 1 < tiles && bounds[tile + 1] + bounds[tile + 2] <= p2) {
+            tile++;
+        }
+
+        msize_t c0 = bounds[tile] + bounds[tile + 1];
+        if (p2 <= c0 || tile + 1 == tiles) {
+            first[p] = second[p] = tile;
+            weight[p] = 0;
+        }
+        else {
+            msize_t c1 = bounds[tile + 1] + bounds[tile + 2];
+            first[p] = tile;
+            second[p] = tile + 1;
+            weight[p] = (uint16_t)(((p2 - c0) << CLAHE_WEIGHT_SHIFT) / (c1 - c0));
+        }
+    }
+}
+
+/**
+ * @brief Converts the given image with the source converter and applies CLAHE on the result.
+ *        Clipped tile histograms are built in parallel, every pixel is then mapped through
+ *        the four nearest tile tables blended bilinearly.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the source converter or image is null or the grid is empty.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_CLAHE::convert(Image* img) {
+
+    if (NULL == _source || NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix = _source->convert(img);
+    msize_t size_x = brightness_matrix->GetXSize();
+    msize_t size_y = brightness_matrix->GetYSize();
+
+    if (0 == size_x || 0 == size_y) {
+        return brightness_matrix;
+    }
+
+    // lay out the tile grid
+    std::vector<msize_t> x_bounds, y_bounds;
+
+    if (0 != _chunk_size && 0 != _chunks_per_tile) {
+        size_t y_chunk_size = (size_t)((float)_chunk_size / _ratio);
+        if (0 == y_chunk_size) {
+            throw AACException(error_codes::CHUNK_SIZE_ERROR);
+        }
+        msize_t x_tile = _chunk_size * _chunks_per_tile;
+        msize_t y_tile = y_chunk_size * _chunks_per_tile;
+        msize_t x_tiles = (size_x / _chunk_size + _chunks_per_tile - 1) / _chunks_per_tile;
+        msize_t y_tiles = (size_y / y_chunk_size + _chunks_per_tile - 1) / _chunks_per_tile;
+
+        tileBounds(size_x, (size_x % _chunk_size) / 2, x_tile, std::max<msize_t>(x_tiles, 1), x_bounds);
+        tileBounds(size_y, (size_y % y_chunk_size) / 2, y_tile, std::max<msize_t>(y_tiles, 1), y_bounds);
+    }
+    else {
+        if (0 == _tiles_x || 0 == _tiles_y) {
+            throw AACException(error_codes::INVALID_ARGUMENTS);
+        }
+        tileBounds(size_x, 0, 0, std::min(_tiles_x, size_x), x_bounds);
+        tileBounds(size_y, 0, 0, std::min(_tiles_y, size_y), y_bounds);
+    }
+
+    msize_t x_tiles = x_bounds.size() - 1;
+    msize_t y_tiles = y_bounds.size() - 1;
+
+    // clipped per tile histograms turned into remap tables
+    std::vector<uint8_t> luts(x_tiles * y_tiles * CLAHE_BINS);
+
+    ParallelBands(0, x_tiles * y_tiles, _threads, [&](unsigned, msize_t tile_start, msize_t tile_end) {
+        for (msize_t tile = tile_start; tile < tile_end; tile++) {
+            msize_t tx = tile % x_tiles;
+            msize_t ty = tile / x_tiles;
+            unsigned long histogram[CLAHE_BINS] = {0};
+
+            for (msize_t y = y_bounds[ty]; y < y_bounds[ty + 1]; y++) {
+                const uint8_t* row = (*brightness_matrix)[y].data();
+                for (msize_t x = x_bounds[tx]; x < x_bounds[tx + 1]; x++) {
+                    histogram[row[x]]++;
+                }
+            }
+
+            unsigned long area = (x_bounds[tx + 1] - x_bounds[tx]) * (y_bounds[ty + 1] - y_bounds[ty]);
+
+            if (_clip_limit > 0) {
+                unsigned long limit = std::max(1ul, (unsigned long)(_clip_limit * area / CLAHE_BINS));
+                unsigned long excess = 0;
+
+                for (unsigned bin = 0; bin < CLAHE_BINS; bin++) {
+                    if (histogram[bin] > limit) {
+                        excess += histogram[bin] - limit;
+                        histogram[bin] = limit;
+                    }
+                }
+
+                // redistribute the clipped excess uniformly
+                unsigned long share = excess / CLAHE_BINS;
+                unsigned long remainder = excess % CLAHE_BINS;
+                for (unsigned bin = 0; bin < CLAHE_BINS; bin++) {
+                    histogram[bin] += share + (bin < remainder);
+                }
+            }
+
+            uint8_t* lut = &luts[tile * CLAHE_BINS];
+            unsigned long cdf = 0;
+            for (unsigned bin = 0; bin < CLAHE_BINS; bin++) {
+                cdf += histogram[bin];
+                lut[bin] = (uint8_t)((cdf * 255 + area / 2) / area);
+            }
+        }
+    });
+
+    // bilinear blend of the neighbouring tile tables
+    std::vector<msize_t> x_first, x_second, y_first, y_second;
+    std::vector<uint16_t> x_weight, y_weight;
+    axisBlend(x_bounds, size_x, x_first, x_second, x_weight);
+    axisBlend(y_bounds, size_y, y_first, y_second, y_weight);
+
+    for (msize_t x = 0; x < size_x; x++) {
+        x_first[x] *= CLAHE_BINS;
+        x_second[x] *= CLAHE_BINS;
+    }
+
+    ParallelBands(0, size_y, _threads, [&](unsigned, msize_t y_start, msize_t y_end) {
+        for (msize_t y = y_start; y < y_end; y++) {
+            uint8_t* row = (*brightness_matrix)[y].data();
+            const uint8_t* upper = &luts[y_first[y] * x_tiles * CLAHE_BINS];
+            const uint8_t* lower = &luts[y_second[y] * x_tiles * CLAHE_BINS];
+            uint32_t wy = y_weight[y];
+
+            for (msize_t x = 0; x < size_x; x++) {
+                uint8_t value = row[x];
+                uint32_t wx = x_weight[x];
+                uint32_t top = upper[x_first[x] + value] * (CLAHE_WEIGHT_ONE - wx) + upper[x_second[x] + value] * wx;
+                uint32_t bottom = lower[x_first[x] + value] * (CLAHE_WEIGHT_ONE - wx) + lower[x_second[x] + value] * wx;
+                row[x] = (uint8_t)((top * (CLAHE_WEIGHT_ONE - wy) + bottom * wy + (1 << (2 * CLAHE_WEIGHT_SHIFT - 1))) >> (2 * CLAHE_WEIGHT_SHIFT));
+            }
+        }
+    });
+
+    return brightness_matrix;
+}
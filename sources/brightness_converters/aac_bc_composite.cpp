@@ -0,0 +1,183 @@
+#include <aac.h>
+
+/**
+ * @file aac_bc_composite.cpp
+ * @brief Contains the implementation of the AAC::BC_Composite class.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Exact rounded division by 255 for products of two 8 bit values.
+ *
+ * @param value The value to divide.
+ * @return value / 255 rounded to nearest.
+ */
+static inline uint32_t div255(uint32_t value) {
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+/**
+ * @brief Constructs a new BC_Composite object.
+ *        Weights have the BC_Simple meaning, so channels are weighted by weight / 3.
+ *
+ * @param red_weight The weight for the red channel.
+ * @param green_weight The weight for the green channel.
+ * @param blue_weight The weight for the blue channel.
+ * @param background Brightness level the image is composited over.
+ * @param negate Flag indicating whether to negate the pixel brightness before compositing.
+ * @param threads Number of threads used for the conversion (0 means hardware concurrency).
+ */
+BC_Composite::BC_Composite(float red_weight, float green_weight, float blue_weight, uint8_t background, uint8_t negate, unsigned threads) :
+    _background(background), _negate(negate), _threads(threads) {
+
+    if (red_weight < 0 || green_weight < 0 || blue_weight < 0) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _red_weight = FixedWeight(red_weight);
+    _green_weight = FixedWeight(green_weight);
+    _blue_weight = FixedWeight(blue_weight);
+}
+
+/**
+ * @brief Converts the given image to a brightness matrix composited over the background level.
+ *        Brightness is computed in fixed point, premultiplied by alpha and blended with the
+ *        background as (brightness * alpha + background * (255 - alpha)) / 255. Fully transparent
+ *        pixels are recorded in a bit mask used by IsTransparent.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the image is null or the pixel type is invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Composite::convert(Image* img) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    return convertRegion(img, {0, img->GetSizeX(), 0, img->GetSizeY()});
+}
+
+/**
+ * @brief Converts the given region of the image to a composited brightness matrix of the image size.
+ *        Pixels outside the region are left at zero and are never reported as transparent.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which brightness is needed.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the image is null or the pixel type is invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Composite::convertRegion(Image* img, const Region& region) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    msize_t size_x = img->GetSizeX();
+    msize_t size_y = img->GetSizeY();
+    Pixel_Type pixel_type = img->GetPixelType();
+
+    if (Pixel_Type::G != pixel_type && Pixel_Type::GA != pixel_type && Pixel_Type::RGB != pixel_type && Pixel_Type::RGBA != pixel_type) {
+        throw AACException(error_codes::INVALID_PIXEL);
+    }
+
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix(new Matrix<uint8_t>(size_x, size_y));
+    const msize_t channels = img->GetChannels();
+    const bool has_alpha = (Pixel_Type::GA == pixel_type || Pixel_Type::RGBA == pixel_type);
+    _opaque_mask = has_alpha ? BitMatrix(size_x, size_y) : BitMatrix();
+    _region = region;
+
+    const uint32_t red_weight = _red_weight, green_weight = _green_weight, blue_weight = _blue_weight;
+    const uint32_t background = _background;
+    const uint32_t negate = _negate ? 255 : 0;
+
+    const msize_t x_start = region.X_start_index;
+    const msize_t x_end = region.X_end_index;
+
+    ParallelBands(region.Y_start_index, region.Y_end_index, _threads, [&](unsigned, msize_t y_start, msize_t y_end) {
+        for (msize_t y = y_start; y < y_end; y++) {
+            const uint8_t* src = img->GetRawRow(y);
+            uint8_t* dst = (*brightness_matrix)[y].data();
+
+            // constant pixel types fold the branch of WeightPixel out of the loops
+            switch (pixel_type) {
+                case Pixel_Type::G:
+                    for (msize_t x = x_start; x < x_end; x++) {
+                        dst[x] = (uint8_t)(WeightPixel(&src[x], Pixel_Type::G, red_weight, green_weight, blue_weight) ^ negate);
+                    }
+                    break;
+                case Pixel_Type::GA:
+                    for (msize_t x = x_start; x < x_end; x++) {
+                        uint32_t brightness = WeightPixel(&src[2 * x], Pixel_Type::GA, red_weight, green_weight, blue_weight) ^ negate;
+                        uint32_t alpha = src[2 * x + 1];
+                        dst[x] = (uint8_t)div255(brightness * alpha + background * (255 - alpha));
+                    }
+                    break;
+                case Pixel_Type::RGB:
+                    for (msize_t x = x_start; x < x_end; x++) {
+                        dst[x] = (uint8_t)(WeightPixel(&src[3 * x], Pixel_Type::RGB, red_weight, green_weight, blue_weight) ^ negate);
+                    }
+                    break;
+                case Pixel_Type::RGBA:
+                default:
+                    for (msize_t x = x_start; x < x_end; x++) {
+                        uint32_t brightness = WeightPixel(&src[4 * x], Pixel_Type::RGBA, red_weight, green_weight, blue_weight) ^ negate;
+                        uint32_t alpha = src[4 * x + 3];
+                        dst[x] = (uint8_t)div255(brightness * alpha + background * (255 - alpha));
+                    }
+                    break;
+            }
+
+            // pack non transparent pixels into the mask
+            if (has_alpha) {
+                uint64_t* mask_row = _opaque_mask.GetRow(y);
+                for (msize_t x = x_start; x < x_end; x++) {
+                    mask_row[x / 64] |= (uint64_t)(0 != src[x * channels + channels - 1]) << (x % 64);
+                }
+            }
+        }
+    });
+
+    return brightness_matrix;
+}
+
+/**
+ * @brief Tells if the given region of the last converted image is fully transparent.
+ *        Regions not fully inside the last converted region are never reported as transparent.
+ *
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param Y_start_index The starting index of the Y-axis (inclusive).
+ * @param Y_end_index The ending index of the Y-axis (exclusive).
+ * @return True if every pixel of the region has zero alpha.
+ */
+bool BC_Composite::IsTransparent(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index) const {
+
+    if (X_start_index >= X_end_index || Y_start_index >= Y_end_index ||
+        X_end_index > _opaque_mask.GetXSize() || Y_end_index > _opaque_mask.GetYSize() ||
+        X_start_index < _region.X_start_index || X_end_index > _region.X_end_index ||
+        Y_start_index < _region.Y_start_index || Y_end_index > _region.Y_end_index) {
+        return false;
+    }
+
+    for (msize_t y = Y_start_index; y < Y_end_index; y++) {
+        if (0 != BitMatrix::CountRow(_opaque_mask.GetRow(y), X_start_index, X_end_index)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Tells if the brightness of every pixel depends on that pixel alone.
+ *
+ * @return Always true.
+ */
+bool BC_Composite::IsPixelLocal() const {
+    return true;
+}
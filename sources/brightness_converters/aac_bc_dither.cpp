@@ -0,0 +1,164 @@
+#include <aac.h>
+
+#include <algorithm>
+#include <atomic>
+
+/**
+ * @file aac_bc_dither.cpp
+ * @brief Contains the implementation of the AAC::BC_Dither class.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Single error diffusion tap (offsets relative to the processed pixel in scan direction).
+ */
+struct DitherTap {
+    int dx;
+    int dy;
+    int weight;
+};
+
+/**
+ * @brief Error diffusion kernel description.
+ */
+struct DitherKernelDesc {
+    const DitherTap* taps;
+    unsigned taps_count;
+    unsigned weight_shift;
+    int reach;
+};
+
+static const DitherTap floyd_steinberg_taps[] = {
+    {1, 0, 7}, {-1, 1, 3}, {0, 1, 5}, {1, 1, 1}
+};
+
+static const DitherTap atkinson_taps[] = {
+    {1, 0, 1}, {2, 0, 1}, {-1, 1, 1}, {0, 1, 1}, {1, 1, 1}, {0, 2, 1}
+};
+
+static const DitherTap sierra_taps[] = {
+    {1, 0, 5}, {2, 0, 3},
+    {-2, 1, 2}, {-1, 1, 4}, {0, 1, 5}, {1, 1, 4}, {2, 1, 2},
+    {-1, 2, 2}, {0, 2, 3}, {1, 2, 2}
+};
+
+/**
+ * @brief Gets the description of the given kernel.
+ *
+ * @param kernel The kernel.
+ * @return The kernel description.
+ */
+static DitherKernelDesc kernelDesc(DitherKernel kernel) {
+    switch (kernel) {
+        case DitherKernel::ATKINSON:
+            return {atkinson_taps, sizeof(atkinson_taps) / sizeof(DitherTap), 3, 2};
+        case DitherKernel::SIERRA:
+            return {sierra_taps, sizeof(sierra_taps) / sizeof(DitherTap), 5, 2};
+        case DitherKernel::FLOYD_STEINBERG:
+        default:
+            return {floyd_steinberg_taps, sizeof(floyd_steinberg_taps) / sizeof(DitherTap), 4, 1};
+    }
+}
+
+/**
+ * @brief Constructs a new BC_Dither object.
+ *
+ * @param source The brightness converter which output is dithered.
+ * @param kernel Error diffusion kernel.
+ * @param serpentine Flag indicating whether every other row is scanned right to left.
+ * @param levels Number of output brightness levels (at least 2).
+ * @param threads Number of threads running the wavefront (0 means hardware concurrency).
+ */
+BC_Dither::BC_Dither(BrightnessConverter* source, DitherKernel kernel, bool serpentine, uint8_t levels, unsigned threads) :
+    _source(source), _kernel(kernel), _serpentine(serpentine), _levels(levels), _threads(threads) {}
+
+/**
+ * @brief Converts the given image with the source converter and quantizes the result with error diffusion.
+ *
+ * Rows are dealt to the threads round robin and processed as a diagonal wavefront: a pixel is only
+ * processed once the row above has advanced far enough that neither of them touches the same error
+ * cells. Rows scanned in opposite directions (serpentine) wait for the row above to finish. Errors live
+ * in a ring of threads + 2 rows, so the extra memory does not depend on the image height.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the source converter or image is null or levels are invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Dither::convert(Image* img) {
+
+    if (NULL == _source || NULL == img || _levels < 2) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix = _source->convert(img);
+    long size_x = brightness_matrix->GetXSize();
+    msize_t size_y = brightness_matrix->GetYSize();
+
+    if (0 == size_x || 0 == size_y) {
+        return brightness_matrix;
+    }
+
+    const DitherKernelDesc desc = kernelDesc(_kernel);
+    const int round = 1 << (desc.weight_shift - 1);
+    const int steps = _levels - 1;
+
+    // row y + 1 must stay lag pixels ahead so both rows never share error cells
+    const long lag = 2 * desc.reach + 1;
+
+    unsigned threads = ResolveThreads(_threads, size_y);
+    msize_t ring_rows = threads + 2;
+    long padded_x = size_x + 2 * desc.reach;
+
+    std::vector<int> errors(ring_rows * padded_x, 0);
+    std::vector<std::atomic<long>> progress(size_y);
+    for (std::atomic<long>& row_progress : progress) {
+        row_progress.store(0, std::memory_order_relaxed);
+    }
+
+    auto reversed = [&](msize_t y) { return _serpentine && (y & 1); };
+    auto error_row = [&](msize_t y) { return &errors[(y % ring_rows) * padded_x + desc.reach]; };
+
+    ParallelBands(0, threads, threads, [&](unsigned worker, msize_t, msize_t) {
+        for (msize_t y = worker; y < size_y; y += threads) {
+            uint8_t* row = (*brightness_matrix)[y].data();
+            bool rtl = reversed(y);
+            bool same_direction = (y > 0) && (reversed(y - 1) == rtl);
+            long above = (y > 0) ? progress[y - 1].load(std::memory_order_acquire) : size_x;
+
+            if (y + 2 < size_y) {
+                std::fill_n(error_row(y + 2) - desc.reach, padded_x, 0);
+            }
+
+            int* error_rows[3] = {error_row(y), error_row(y + 1), error_row(y + 2)};
+            int rows_below = (int)std::min<msize_t>(2, size_y - 1 - y);
+
+            for (long i = 0; i < size_x; i++) {
+                long needed = same_direction ? std::min(size_x, i + lag + 1) : size_x;
+                while (above < needed) {
+                    std::this_thread::yield();
+                    above = progress[y - 1].load(std::memory_order_acquire);
+                }
+
+                long x = rtl ? size_x - 1 - i : i;
+                int value = std::max(0, std::min(255, row[x] + ((error_rows[0][x] + round) >> desc.weight_shift)));
+                int quantized = (value * steps + 127) / 255 * 255 / steps;
+                int error = value - quantized;
+                row[x] = (uint8_t)quantized;
+
+                for (unsigned tap = 0; tap < desc.taps_count; tap++) {
+                    const DitherTap& t = desc.taps[tap];
+                    if (t.dy > rows_below) {
+                        continue;
+                    }
+                    error_rows[t.dy][rtl ? x - t.dx : x + t.dx] += error * t.weight;
+                }
+
+                progress[y].store(i + 1, std::memory_order_release);
+            }
+        }
+    });
+
+    return brightness_matrix;
+}
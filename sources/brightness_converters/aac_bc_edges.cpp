@@ -0,0 +1,152 @@
+#include <aac.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "aac_bc_bands.h"
+
+/**
+ * @file aac_bc_edges.cpp
+ * @brief Contains the implementation of the AAC::BC_Edges class.
+ */
+
+using namespace AAC;
+
+// M_PI is not standard C++
+static constexpr double PI = 3.14159265358979323846;
+
+/**
+ * @brief Constructs a new BC_Edges object.
+ *
+ * @param source The brightness converter which output edges are detected on.
+ * @param op Gradient operator (Sobel or Scharr).
+ * @param directions Flag indicating whether gradient directions are stored alongside the magnitude.
+ * @param threads Number of threads used for the row bands (0 means hardware concurrency).
+ */
+BC_Edges::BC_Edges(BrightnessConverter* source, EdgeOperator op, bool directions, unsigned threads) :
+    _source(source), _operator(op), _directions(directions), _threads(threads) {}
+
+/**
+ * @brief Converts the given image with the source converter and replaces it with the gradient magnitude.
+ *        The kernel is applied separably: every row gets a horizontal derivative and smoothing pass which
+ *        are kept in a three row rolling buffer and combined vertically, so the result is written in place.
+ *        The magnitude is the L1 norm of the gradient normalized by the kernel weight.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the source converter or image is null.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Edges::convert(Image* img) {
+
+    if (NULL == _source || NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    return convertRegion(img, {0, img->GetSizeX(), 0, img->GetSizeY()});
+}
+
+/**
+ * @brief Converts the given region of the image to the gradient magnitude. The source converter is
+ *        asked for the region grown by the one pixel border the kernel reads.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which brightness is needed.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the source converter or image is null.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Edges::convertRegion(Image* img, const Region& region) {
+
+    if (NULL == _source || NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    msize_t size_x = img->GetSizeX();
+    msize_t size_y = img->GetSizeY();
+    msize_t x_start = region.X_start_index;
+    msize_t x_end = region.X_end_index;
+
+    Region source_region = {x_start > 0 ? x_start - 1 : 0, std::min(x_end + 1, size_x),
+                            region.Y_start_index > 0 ? region.Y_start_index - 1 : 0, std::min(region.Y_end_index + 1, size_y)};
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix = _source->convertRegion(img, source_region);
+
+    _direction_matrix.reset(_directions ? new Matrix<uint8_t>(size_x, size_y) : NULL);
+
+    if (0 == size_x || 0 == size_y || x_start >= x_end) {
+        return brightness_matrix;
+    }
+
+    // smoothing taps (side, center) and log2 of the kernel weight
+    const int16_t side = (EdgeOperator::SCHARR == _operator) ? 3 : 1;
+    const int16_t center = (EdgeOperator::SCHARR == _operator) ? 10 : 2;
+    const unsigned norm_shift = (EdgeOperator::SCHARR == _operator) ? 4 : 2;
+    Matrix<uint8_t>* directions = _direction_matrix.get();
+
+    // loaded row layout: [ derivative | smoothed ], border pixels of the image are replicated
+    auto load = [&](const uint8_t* src, int16_t* loaded) {
+        int16_t* derivative = loaded;
+        int16_t* smoothed = loaded + size_x;
+
+        auto load_border = [&](msize_t x) {
+            uint8_t left = src[x > 0 ? x - 1 : 0];
+            uint8_t right = src[std::min(x + 1, size_x - 1)];
+            derivative[x] = right - left;
+            smoothed[x] = side * (left + right) + center * src[x];
+        };
+
+        load_border(x_start);
+        for (msize_t x = x_start + 1; x + 1 < x_end; x++) {
+            derivative[x] = src[x + 1] - src[x - 1];
+            smoothed[x] = side * (src[x - 1] + src[x + 1]) + center * src[x];
+        }
+        if (x_end - x_start > 1) {
+            load_border(x_end - 1);
+        }
+    };
+
+    auto emit = [&](const int16_t* const* window, msize_t y, uint8_t* dst) {
+        const int16_t* d_up = window[0];
+        const int16_t* d_mid = window[1];
+        const int16_t* d_down = window[2];
+        const int16_t* s_up = window[0] + size_x;
+        const int16_t* s_down = window[2] + size_x;
+
+        for (msize_t x = x_start; x < x_end; x++) {
+            int gx = side * (d_up[x] + d_down[x]) + center * d_mid[x];
+            int gy = s_down[x] - s_up[x];
+            int magnitude = (std::abs(gx) + std::abs(gy)) >> norm_shift;
+            dst[x] = (uint8_t)std::min(magnitude, 255);
+        }
+
+        if (NULL != directions) {
+            uint8_t* direction_row = (*directions)[y].data();
+            for (msize_t x = x_start; x < x_end; x++) {
+                int gx = side * (d_up[x] + d_down[x]) + center * d_mid[x];
+                int gy = s_down[x] - s_up[x];
+
+                // orientation modulo half turn mapped onto 0..255
+                float angle = std::atan2((float)gy, (float)gx);
+                if (angle < 0) {
+                    angle += (float)PI;
+                }
+                direction_row[x] = (uint8_t)((unsigned)(angle * 256.0f / (float)PI) & 0xFF);
+            }
+        }
+    };
+
+    FilterRowBands<int16_t>(*brightness_matrix, region, 1, 2 * size_x, _threads, load, emit);
+
+    return brightness_matrix;
+}
+
+/**
+ * @brief Gets the gradient directions computed by the last conversion.
+ *        Directions are angles modulo half turn mapped onto 0..255 (0 means horizontal gradient).
+ *
+ * @return A shared pointer to the directions matrix, null if directions are disabled.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Edges::GetDirections() const {
+    return _direction_matrix;
+}
@@ -0,0 +1,112 @@
+#include <aac.h>
+
+#include <array>
+
+/**
+ * @file aac_bc_equalize.cpp
+ * @brief Contains the implementation of the AAC::BC_Equalize class.
+ */
+
+using namespace AAC;
+
+#define EQUALIZE_BINS 256
+
+/**
+ * @brief Constructs a new BC_Equalize object.
+ *
+ * @param source The brightness converter which output is equalized.
+ * @param threads Number of threads used for the histogram and remap passes (0 means hardware concurrency).
+ */
+BC_Equalize::BC_Equalize(BrightnessConverter* source, unsigned threads) : _source(source), _threads(threads) {}
+
+/**
+ * @brief Converts the given image with the source converter and equalizes the resulting histogram.
+ *        The histogram is gathered in per-thread sub-histograms which are merged afterwards, then
+ *        the cumulative distribution is turned into a remap table applied in a second pass.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the source converter or image is null.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Equalize::convert(Image* img) {
+
+    if (NULL == _source || NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix = _source->convert(img);
+    msize_t size_x = brightness_matrix->GetXSize();
+    msize_t size_y = brightness_matrix->GetYSize();
+
+    if (0 == size_x || 0 == size_y) {
+        return brightness_matrix;
+    }
+
+    // gather per thread sub-histograms
+    std::vector<std::array<unsigned long, EQUALIZE_BINS>> sub_histograms(ResolveThreads(_threads, size_y));
+
+    ParallelBands(0, size_y, _threads, [&](unsigned band, msize_t y_start, msize_t y_end) {
+        std::array<unsigned long, EQUALIZE_BINS>& histogram = sub_histograms[band];
+        histogram.fill(0);
+
+        for (msize_t y = y_start; y < y_end; y++) {
+            const uint8_t* row = (*brightness_matrix)[y].data();
+            for (msize_t x = 0; x < size_x; x++) {
+                histogram[row[x]]++;
+            }
+        }
+    });
+
+    // merge and build the remap table from the cumulative distribution
+    unsigned long histogram[EQUALIZE_BINS] = {0};
+    for (const std::array<unsigned long, EQUALIZE_BINS>& sub_histogram : sub_histograms) {
+        for (unsigned bin = 0; bin < EQUALIZE_BINS; bin++) {
+            histogram[bin] += sub_histogram[bin];
+        }
+    }
+
+    unsigned long total = (unsigned long)size_x * size_y;
+    unsigned long cdf_min = 0;
+    for (unsigned bin = 0; bin < EQUALIZE_BINS && 0 == cdf_min; bin++) {
+        cdf_min = histogram[bin];
+    }
+
+    // single brightness image has nothing to stretch
+    if (total == cdf_min) {
+        return brightness_matrix;
+    }
+
+    uint8_t lut[EQUALIZE_BINS];
+    unsigned long cdf = 0;
+    for (unsigned bin = 0; bin < EQUALIZE_BINS; bin++) {
+        cdf += histogram[bin];
+        lut[bin] = (cdf <= cdf_min) ? 0 : (uint8_t)(((cdf - cdf_min) * 255 + (total - cdf_min) / 2) / (total - cdf_min));
+    }
+
+    // remap pass
+    ParallelBands(0, size_y, _threads, [&](unsigned, msize_t y_start, msize_t y_end) {
+        for (msize_t y = y_start; y < y_end; y++) {
+            uint8_t* row = (*brightness_matrix)[y].data();
+            for (msize_t x = 0; x < size_x; x++) {
+                row[x] = lut[row[x]];
+            }
+        }
+    });
+
+    return brightness_matrix;
+}
+
+/**
+ * @brief Tells if the given region is fully transparent. Equalization remaps every value
+ *        independently, so uniform regions of the source stay uniform.
+ *
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param Y_start_index The starting index of the Y-axis (inclusive).
+ * @param Y_end_index The ending index of the Y-axis (exclusive).
+ * @return True if the source reports the region as fully transparent.
+ */
+bool BC_Equalize::IsTransparent(msize_t X_start_index, msize_t X_end_index, msize_t Y_start_index, msize_t Y_end_index) const {
+    return NULL != _source && _source->IsTransparent(X_start_index, X_end_index, Y_start_index, Y_end_index);
+}
@@ -0,0 +1,111 @@
+#include <aac.h>
+
+/**
+ * @file aac_bc_pipeline.cpp
+ * @brief Contains the implementation of the AAC::BC_Pipeline stages.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Constructs a new Weights stage. Channels are weighted by weight / 3.
+ *
+ * @param red_weight The weight for the red channel.
+ * @param green_weight The weight for the green channel.
+ * @param blue_weight The weight for the blue channel.
+ */
+Stage::Weights::Weights(float red_weight, float green_weight, float blue_weight) :
+    red_weight(red_weight), green_weight(green_weight), blue_weight(blue_weight) {}
+
+/**
+ * @brief Constructs a new Gamma stage.
+ *
+ * @param gamma The gamma exponent (values above 1 darken the image).
+ *
+ * @throws error_code An exception is thrown if the exponent is not positive.
+ */
+Stage::Gamma::Gamma(float gamma) : gamma(gamma) {
+    if (!(gamma > 0)) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+}
+
+/**
+ * @brief Applies the gamma curve as 255 * (value / 255) ^ gamma.
+ *
+ * @param value The brightness.
+ * @return The corrected brightness.
+ */
+uint8_t Stage::Gamma::Apply(uint8_t value) const {
+    return (uint8_t)std::lround(255.0f * std::pow(value / 255.0f, gamma));
+}
+
+/**
+ * @brief Negates the brightness.
+ *
+ * @param value The brightness.
+ * @return 255 - value.
+ */
+uint8_t Stage::Negate::Apply(uint8_t value) const {
+    return 255 - value;
+}
+
+/**
+ * @brief Constructs a new Contrast stage.
+ *
+ * @param factor The contrast factor (values above 1 increase the contrast).
+ * @param pivot The brightness level left unchanged.
+ */
+Stage::Contrast::Contrast(float factor, float pivot) : factor(factor), pivot(pivot) {}
+
+/**
+ * @brief Scales the brightness distance from the pivot, saturating at 0 and 255.
+ *
+ * @param value The brightness.
+ * @return The adjusted brightness.
+ */
+uint8_t Stage::Contrast::Apply(uint8_t value) const {
+    long adjusted = std::lround((value - pivot) * factor + pivot);
+    return (uint8_t)std::max(0l, std::min(255l, adjusted));
+}
+
+/**
+ * @brief Constructs a new Clamp stage.
+ *
+ * @param low The lowest allowed brightness.
+ * @param high The highest allowed brightness.
+ *
+ * @throws error_code An exception is thrown if the range is empty.
+ */
+Stage::Clamp::Clamp(uint8_t low, uint8_t high) : low(low), high(high) {
+    if (low > high) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+}
+
+/**
+ * @brief Clamps the brightness into the range.
+ *
+ * @param value The brightness.
+ * @return The clamped brightness.
+ */
+uint8_t Stage::Clamp::Apply(uint8_t value) const {
+    return std::max(low, std::min(high, value));
+}
+
+/**
+ * @brief Constructs a new Brightness stage.
+ *
+ * @param offset The offset added to the brightness.
+ */
+Stage::Brightness::Brightness(int offset) : offset(offset) {}
+
+/**
+ * @brief Adds the offset to the brightness, saturating at 0 and 255.
+ *
+ * @param value The brightness.
+ * @return The shifted brightness.
+ */
+uint8_t Stage::Brightness::Apply(uint8_t value) const {
+    return (uint8_t)std::max(0, std::min(255, value + offset));
+}
@@ -0,0 +1,156 @@
+/**
+ * @file aac_bc_pipeline.tpp
+ * @brief Contains the implementation of the AAC::BC_Pipeline class.
+ */
+
+using namespace AAC;
+
+template <typename PixelStage, typename... ValueStages>
+/**
+ * @brief Constructs a new BC_Pipeline object. Value stages are applied in order to every
+ *        possible brightness level, so the whole chain costs a single table lookup per pixel.
+ *
+ * @param pixel_stage The pixel stage computing the brightness.
+ * @param value_stages The value stages applied to the brightness, in order.
+ *
+ * @throws error_code An exception is thrown if the weights are negative.
+ */
+BC_Pipeline<PixelStage, ValueStages...>::BC_Pipeline(const PixelStage& pixel_stage, const ValueStages&... value_stages) {
+
+    static_assert(std::is_same<PixelStage, Stage::Weights>::value, "the first pipeline stage must be a pixel stage");
+
+    if (pixel_stage.red_weight < 0 || pixel_stage.green_weight < 0 || pixel_stage.blue_weight < 0) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _red_weight = FixedWeight(pixel_stage.red_weight);
+    _green_weight = FixedWeight(pixel_stage.green_weight);
+    _blue_weight = FixedWeight(pixel_stage.blue_weight);
+
+    for (unsigned level = 0; level < 256; level++) {
+        uint8_t value = (uint8_t)level;
+        ((value = value_stages.Apply(value)), ...);
+        _lut[level] = value;
+    }
+}
+
+template <typename PixelStage, typename... ValueStages>
+template <msize_t channels>
+/**
+ * @brief Runs the fused kernel over a part of a source row with the given number of channels.
+ *        Alpha channels are ignored. Without value stages the table lookup is compiled out.
+ *
+ * @param src The raw source row.
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param row Output row, indexed with image x coordinates.
+ */
+void BC_Pipeline<PixelStage, ValueStages...>::weightRow(const uint8_t* src, msize_t X_start_index, msize_t X_end_index, uint8_t* row) const {
+    constexpr Pixel_Type pixel_type = (channels < 3) ? Pixel_Type::G : Pixel_Type::RGB;
+    const uint32_t red_weight = _red_weight, green_weight = _green_weight, blue_weight = _blue_weight;
+
+    for (msize_t x = X_start_index; x < X_end_index; x++) {
+        uint8_t brightness = WeightPixel(&src[channels * x], pixel_type, red_weight, green_weight, blue_weight);
+        if constexpr (sizeof...(ValueStages) > 0) {
+            brightness = _lut[brightness];
+        }
+        row[x] = brightness;
+    }
+}
+
+template <typename PixelStage, typename... ValueStages>
+/**
+ * @brief Converts the given image to a brightness matrix in a single pass.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the image is null or the pixel type is invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Pipeline<PixelStage, ValueStages...>::convert(Image* img) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    return convertRegion(img, {0, img->GetSizeX(), 0, img->GetSizeY()});
+}
+
+template <typename PixelStage, typename... ValueStages>
+/**
+ * @brief Converts the given region of the image to a brightness matrix of the image size.
+ *        Pixels outside the region are left at zero.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which brightness is needed.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the image is null or the pixel type is invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Pipeline<PixelStage, ValueStages...>::convertRegion(Image* img, const Region& region) {
+
+    if (NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix(new Matrix<uint8_t>(img->GetSizeX(), img->GetSizeY()));
+
+    for (msize_t y = region.Y_start_index; y < region.Y_end_index; y++) {
+        convertRow(img, y, region.X_start_index, region.X_end_index, (*brightness_matrix)[y].data());
+    }
+
+    return brightness_matrix;
+}
+
+template <typename PixelStage, typename... ValueStages>
+/**
+ * @brief Tells if the converter can compute brightness row by row.
+ *
+ * @return Always true.
+ */
+bool BC_Pipeline<PixelStage, ValueStages...>::SupportsRows() const {
+    return true;
+}
+
+template <typename PixelStage, typename... ValueStages>
+/**
+ * @brief Tells if the brightness of every pixel depends on that pixel alone.
+ *
+ * @return Always true.
+ */
+bool BC_Pipeline<PixelStage, ValueStages...>::IsPixelLocal() const {
+    return true;
+}
+
+template <typename PixelStage, typename... ValueStages>
+/**
+ * @brief Computes brightness of a part of a single image row. The pixel type is resolved once per row.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param y The row index.
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param row Output row, indexed with image x coordinates.
+ *
+ * @throws error_code An exception is thrown if the pixel type is invalid.
+ */
+void BC_Pipeline<PixelStage, ValueStages...>::convertRow(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index, uint8_t* row) {
+    const uint8_t* src = img->GetRawRow(y);
+
+    switch (img->GetPixelType()) {
+        case Pixel_Type::G:
+            weightRow<1>(src, X_start_index, X_end_index, row);
+            break;
+        case Pixel_Type::GA:
+            weightRow<2>(src, X_start_index, X_end_index, row);
+            break;
+        case Pixel_Type::RGB:
+            weightRow<3>(src, X_start_index, X_end_index, row);
+            break;
+        case Pixel_Type::RGBA:
+            weightRow<4>(src, X_start_index, X_end_index, row);
+            break;
+        default:
+            throw AACException(error_codes::INVALID_PIXEL);
+    }
+}
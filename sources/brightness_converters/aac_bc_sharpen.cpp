@@ -0,0 +1,101 @@
+#include <aac.h>
+
+#include "aac_bc_blur.h"
+
+/**
+ * @file aac_bc_sharpen.cpp
+ * @brief Contains the implementation of the AAC::BC_Sharpen class.
+ */
+
+using namespace AAC;
+
+#define SHARPEN_AMOUNT_SHIFT 8
+#define SHARPEN_MAX_GAUSSIAN_RADIUS 8
+
+/**
+ * @brief Constructs a new BC_Sharpen object.
+ *
+ * @param source The brightness converter which output is sharpened.
+ * @param amount Strength k of the mask, the result is original + k * (original - blurred).
+ * @param kernel Blur kernel of the mask (box or Gaussian).
+ * @param radius Blur kernel radius.
+ * @param threads Number of threads used for the row bands (0 means hardware concurrency).
+ *
+ * @throws error_code An exception is thrown if the amount is negative or the Gaussian radius is bigger than 8.
+ */
+BC_Sharpen::BC_Sharpen(BrightnessConverter* source, float amount, BlurKernel kernel, msize_t radius, unsigned threads) :
+    _source(source), _kernel(kernel), _radius(radius), _threads(threads) {
+
+    if (amount < 0 || (BlurKernel::GAUSSIAN == kernel && radius > SHARPEN_MAX_GAUSSIAN_RADIUS)) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    _amount = (int32_t)std::lround(amount * (1 << SHARPEN_AMOUNT_SHIFT));
+
+    if (BlurKernel::GAUSSIAN == kernel) {
+        _weights = BinomialWeights(radius);
+    }
+}
+
+/**
+ * @brief Converts the given image with the source converter and sharpens the result.
+ *
+ * @param img A pointer to the image to be converted.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the source converter or image is null.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Sharpen::convert(Image* img) {
+
+    if (NULL == _source || NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    return convertRegion(img, {0, img->GetSizeX(), 0, img->GetSizeY()});
+}
+
+/**
+ * @brief Converts the given region of the image with the source converter and sharpens it in place.
+ *        The blurred row is produced by the streaming blur bands and combined with the original row
+ *        before it is overwritten, so the extra memory is a few rows per band. The result saturates
+ *        at 0 and 255.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which brightness is needed.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the source converter or image is null.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Sharpen::convertRegion(Image* img, const Region& region) {
+
+    if (NULL == _source || NULL == img) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    msize_t size_x = img->GetSizeX();
+    msize_t size_y = img->GetSizeY();
+    msize_t x_start = region.X_start_index;
+    msize_t x_end = region.X_end_index;
+    const msize_t radius = _radius;
+
+    Region source_region = {x_start > radius ? x_start - radius : 0, std::min(x_end + radius, size_x),
+                            region.Y_start_index > radius ? region.Y_start_index - radius : 0, std::min(region.Y_end_index + radius, size_y)};
+    std::shared_ptr<Matrix<uint8_t>> brightness_matrix = _source->convertRegion(img, source_region);
+
+    if (0 == radius || 0 == _amount || 0 == size_x || 0 == size_y || x_start >= x_end) {
+        return brightness_matrix;
+    }
+
+    const int32_t amount = _amount;
+    BlurRowBands(*brightness_matrix, region, _kernel, radius, _weights, _threads,
+                 [amount](uint8_t original, uint8_t blurred) {
+                     int32_t detail = ((int32_t)original - blurred) * amount;
+
+                     // round half away from zero, so darkening and brightening are symmetric
+                     const int32_t half = 1 << (SHARPEN_AMOUNT_SHIFT - 1);
+                     int32_t value = original + ((detail >= 0) ? (detail + half) >> SHARPEN_AMOUNT_SHIFT : -((half - detail) >> SHARPEN_AMOUNT_SHIFT));
+                     return (uint8_t)std::max(0, std::min(255, value));
+                 });
+
+    return brightness_matrix;
+}
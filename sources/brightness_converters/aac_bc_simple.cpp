@@ -33,52 +33,99 @@ BC_Simple::BC_Simple() : BC_Simple::BC_Simple(1, 1, 1) {}
  * @throws error_code An exception is thrown if the pixel type is invalid.
  */
 std::shared_ptr<Matrix<uint8_t>> BC_Simple::convert(Image* img) {
+    return convertRegion(img, {0, img->GetSizeX(), 0, img->GetSizeY()});
+}
+
+/**
+ * @brief Converts the given region of the image to a brightness matrix of the image size.
+ *        Pixels outside the region are left at zero.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which brightness is needed.
+ * @return A shared pointer to the resulting brightness matrix.
+ *
+ * @throws error_code An exception is thrown if the pixel type is invalid.
+ */
+std::shared_ptr<Matrix<uint8_t>> BC_Simple::convertRegion(Image* img, const Region& region) {
     std::shared_ptr<Matrix<uint8_t>> brightness_matrix(new Matrix<uint8_t>(img->GetSizeX(), img->GetSizeY()));
-    void *raw_pixels_matrix = img->GetMatrix();
 
-    for (msize_t y = 0; y < img->GetSizeY(); y++)
+    for (msize_t y = region.Y_start_index; y < region.Y_end_index; y++)
     {
-        for (msize_t x = 0; x < img->GetSizeX(); x++)
-        {
-            switch (img->GetPixelType())
-            {
-            case Pixel_Type::G:
-            {
-                Matrix<Pixel<Pixel_Type::G>> *pixels_g = reinterpret_cast<Matrix<Pixel<Pixel_Type::G>> *>(raw_pixels_matrix);
+        convertRow(img, y, region.X_start_index, region.X_end_index, (*brightness_matrix)[y].data());
+    }
 
-                (*brightness_matrix)[y][x] = _negate*255 + (_negate ? -1 : 1) * ((*pixels_g)[y][x].GetPixelValues().grey*(_red_weight + _green_weight + _blue_weight)/3);
-                break;
-            }
-            case Pixel_Type::GA:
-            {
-                Matrix<Pixel<Pixel_Type::GA>> *pixels_ga = reinterpret_cast<Matrix<Pixel<Pixel_Type::GA>> *>(raw_pixels_matrix);
-                struct Pixel_GA ga = (*pixels_ga)[y][x].GetPixelValues();
+    return brightness_matrix;
+}
 
-                (*brightness_matrix)[y][x] = _negate*255 + (_negate ? -1 : 1) * ((ga.grey + ga.alpha)*(_red_weight + _green_weight + _blue_weight)/3 / 2);
-                break;
-            }
-            case Pixel_Type::RGB:
-            {
-                Matrix<Pixel<Pixel_Type::RGB>> *pixels_rgb = reinterpret_cast<Matrix<Pixel<Pixel_Type::RGB>> *>(raw_pixels_matrix);
-                struct Pixel_RGB rgb = (*pixels_rgb)[y][x].GetPixelValues();
+/**
+ * @brief Tells if the converter can compute brightness row by row.
+ *
+ * @return Always true.
+ */
+bool BC_Simple::SupportsRows() const {
+    return true;
+}
 
-                (*brightness_matrix)[y][x] = _negate*255 + (_negate ? -1 : 1) * (rgb.red*_red_weight / 3 + rgb.green*_green_weight / 3 + rgb.blue*_blue_weight / 3);
-                break;
-            }
-            case Pixel_Type::RGBA:
-            {
-                Matrix<Pixel<Pixel_Type::RGBA>> *pixels_rgba = reinterpret_cast<Matrix<Pixel<Pixel_Type::RGBA>> *>(raw_pixels_matrix);
-                struct Pixel_RGBA rgba = (*pixels_rgba)[y][x].GetPixelValues();
+/**
+ * @brief Tells if the brightness of every pixel depends on that pixel alone.
+ *
+ * @return Always true.
+ */
+bool BC_Simple::IsPixelLocal() const {
+    return true;
+}
+
+/**
+ * @brief Computes brightness of a part of a single image row using the specified weights and negate flag.
+ *        The pixel type is resolved once per row, so the inner loops stay branch free.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param y The row index.
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param row Output row, indexed with image x coordinates.
+ *
+ * @throws error_code An exception is thrown if the pixel type is invalid.
+ */
+void BC_Simple::convertRow(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index, uint8_t* row) {
+    const uint8_t* src = img->GetRawRow(y);
 
-                (*brightness_matrix)[y][x] = _negate*255 + (_negate ? -1 : 1) * (rgba.red*(_red_weight / 6) + rgba.green*(_green_weight / 6) + rgba.blue*(_blue_weight / 6) + rgba.alpha / 2);
-                break;
-            }
-            default:
-                throw AACException(error_codes::INVALID_PIXEL);
-                break;
-            }
+    switch (img->GetPixelType())
+    {
+    case Pixel_Type::G:
+    {
+        for (msize_t x = X_start_index; x < X_end_index; x++)
+        {
+            row[x] = _negate*255 + (_negate ? -1 : 1) * (src[x]*(_red_weight + _green_weight + _blue_weight)/3);
         }
+        break;
+    }
+    case Pixel_Type::GA:
+    {
+        for (msize_t x = X_start_index; x < X_end_index; x++)
+        {
+            row[x] = _negate*255 + (_negate ? -1 : 1) * ((src[2*x] + src[2*x + 1])*(_red_weight + _green_weight + _blue_weight)/3 / 2);
+        }
+        break;
+    }
+    case Pixel_Type::RGB:
+    {
+        for (msize_t x = X_start_index; x < X_end_index; x++)
+        {
+            row[x] = _negate*255 + (_negate ? -1 : 1) * (src[3*x]*_red_weight / 3 + src[3*x + 1]*_green_weight / 3 + src[3*x + 2]*_blue_weight / 3);
+        }
+        break;
+    }
+    case Pixel_Type::RGBA:
+    {
+        for (msize_t x = X_start_index; x < X_end_index; x++)
+        {
+            row[x] = _negate*255 + (_negate ? -1 : 1) * (src[4*x]*(_red_weight / 6) + src[4*x + 1]*(_green_weight / 6) + src[4*x + 2]*(_blue_weight / 6) + src[4*x + 3] / 2);
+        }
+        break;
+    }
+    default:
+        throw AACException(error_codes::INVALID_PIXEL);
+        break;
     }
-
-    return brightness_matrix;
 }
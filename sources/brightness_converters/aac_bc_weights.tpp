@@ -0,0 +1,83 @@
+/**
+ * @file aac_bc_weights.tpp
+ * @brief Contains the fixed point channel weighting shared by the weighting brightness converters.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Converts a BC_Simple style channel weight (channel is weighted by weight / 3) to fixed point.
+ *        The division by 3 is left to WeightPixel, so integer weights stay exact.
+ *
+ * @param weight The weight.
+ * @return The fixed point weight.
+ */
+inline uint32_t FixedWeight(float weight) {
+    return (uint32_t)std::lround(weight * (1 << WEIGHT_SHIFT));
+}
+
+/**
+ * @brief Computes weighted brightness of a single pixel in fixed point, alpha is ignored.
+ *
+ * @param src The raw pixel.
+ * @param pixel_type The pixel type.
+ * @param red_weight Fixed point red weight.
+ * @param green_weight Fixed point green weight.
+ * @param blue_weight Fixed point blue weight.
+ * @return The brightness.
+ */
+inline uint8_t WeightPixel(const uint8_t* src, Pixel_Type pixel_type, uint32_t red_weight, uint32_t green_weight, uint32_t blue_weight) {
+    uint32_t weighted = (Pixel_Type::G == pixel_type || Pixel_Type::GA == pixel_type) ?
+        src[0] * (red_weight + green_weight + blue_weight) :
+        src[0] * red_weight + src[1] * green_weight + src[2] * blue_weight;
+    // single rounded division by 3 << WEIGHT_SHIFT, (1, 1, 1) maps every value onto itself
+    constexpr uint32_t divisor = 3u << WEIGHT_SHIFT;
+    return (uint8_t)std::min<uint32_t>(255, (weighted + divisor / 2) / divisor);
+}
+
+/**
+ * @brief Computes weighted brightness of a part of an image row and maps it through a lookup table
+ *        in the same loop. The pixel type is resolved once per row, alpha is ignored.
+ *
+ * @param img A pointer to the image.
+ * @param y The row index.
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param red_weight Fixed point red weight.
+ * @param green_weight Fixed point green weight.
+ * @param blue_weight Fixed point blue weight.
+ * @param lut The 256 entry lookup table.
+ * @param row Output row, indexed with image x coordinates.
+ *
+ * @throws error_code An exception is thrown if the pixel type is invalid.
+ */
+inline void WeightRowLut(Image* img, msize_t y, msize_t X_start_index, msize_t X_end_index,
+                         uint32_t red_weight, uint32_t green_weight, uint32_t blue_weight, const uint8_t* lut, uint8_t* row) {
+    const uint8_t* src = img->GetRawRow(y);
+
+    // constant pixel types fold the branch of WeightPixel out of the loops
+    switch (img->GetPixelType()) {
+        case Pixel_Type::G:
+            for (msize_t x = X_start_index; x < X_end_index; x++) {
+                row[x] = lut[WeightPixel(&src[x], Pixel_Type::G, red_weight, green_weight, blue_weight)];
+            }
+            break;
+        case Pixel_Type::GA:
+            for (msize_t x = X_start_index; x < X_end_index; x++) {
+                row[x] = lut[WeightPixel(&src[2 * x], Pixel_Type::GA, red_weight, green_weight, blue_weight)];
+            }
+            break;
+        case Pixel_Type::RGB:
+            for (msize_t x = X_start_index; x < X_end_index; x++) {
+                row[x] = lut[WeightPixel(&src[3 * x], Pixel_Type::RGB, red_weight, green_weight, blue_weight)];
+            }
+            break;
+        case Pixel_Type::RGBA:
+            for (msize_t x = X_start_index; x < X_end_index; x++) {
+                row[x] = lut[WeightPixel(&src[4 * x], Pixel_Type::RGBA, red_weight, green_weight, blue_weight)];
+            }
+            break;
+        default:
+            throw AACException(error_codes::INVALID_PIXEL);
+    }
+}
@@ -0,0 +1,82 @@
+#include <aac.h>
+
+/**
+ * @file aac_brightness_converter.cpp
+ * @brief Contains the default implementation of the AAC::BrightnessConverter interface.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Converts only the given region of the image to a brightness matrix. The matrix keeps
+ *        the image size, values outside the region are unspecified. Converters without region
+ *        support convert the whole image.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which brightness is needed.
+ * @return A shared pointer to the resulting brightness matrix.
+ */
+std::shared_ptr<Matrix<uint8_t>> BrightnessConverter::convertRegion(Image* img, const Region&) {
+    return convert(img);
+}
+
+/**
+ * @brief Tells if the given region of the last converted image is fully transparent.
+ *        Converters without transparency information never report transparent regions.
+ *
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param Y_start_index The starting index of the Y-axis (inclusive).
+ * @param Y_end_index The ending index of the Y-axis (exclusive).
+ * @return True if every pixel of the region is fully transparent.
+ */
+bool BrightnessConverter::IsTransparent(msize_t, msize_t, msize_t, msize_t) const {
+    return false;
+}
+
+/**
+ * @brief Tells if the brightness of every pixel depends on that pixel alone. Only such converters
+ *        can reuse the sums of unchanged chunks between frames. Converters using neighbours or
+ *        image wide statistics are not pixel local.
+ *
+ * @return False for the default converter.
+ */
+bool BrightnessConverter::IsPixelLocal() const {
+    return false;
+}
+
+/**
+ * @brief Tells if the converter can compute brightness row by row straight from the image.
+ *        Such converters can be fused with the chunk reduction, so the full brightness
+ *        matrix is never materialized.
+ *
+ * @return True if convertRow is implemented.
+ */
+bool BrightnessConverter::SupportsRows() const {
+    return false;
+}
+
+/**
+ * @brief Prepares the converter for row conversion of the given region of the image. Called once
+ *        before the rows of a new image are converted, so image wide statistics can be gathered.
+ *        Converters without such statistics do nothing.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param region The region which rows are going to be converted.
+ */
+void BrightnessConverter::prepareRows(Image*, const Region&) {}
+
+/**
+ * @brief Computes brightness of a part of a single image row.
+ *
+ * @param img A pointer to the image to be converted.
+ * @param y The row index.
+ * @param X_start_index The starting index of the X-axis (inclusive).
+ * @param X_end_index The ending index of the X-axis (exclusive).
+ * @param row Output row, indexed with image x coordinates.
+ *
+ * @throws error_code An exception is thrown as the converter does not support row conversion.
+ */
+void BrightnessConverter::convertRow(Image*, msize_t, msize_t, msize_t, uint8_t*) {
+    throw AACException(error_codes::BRIGHTNESS_CALCULATION_FAIL);
+}
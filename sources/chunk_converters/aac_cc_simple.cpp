@@ -29,14 +29,17 @@ uint8_t get_char_index(size_t interval_length, uint8_t brightness) {
 CC_Simple::CC_Simple(std::string alphabet) : _alphabet(alphabet) {}
 
 /**
- * @brief Converts the given matrix of chunks to a string using a simple character mapping.
+ * @brief Converts the given chunk brightness sums to a string using a simple character mapping.
+ *        Lines are converted in parallel.
  *
- * @param chunks A pointer to the matrix of chunks to be converted.
- * @return The resulting string representation of the converted chunks.
+ * @param sums A pointer to the matrix of chunk brightness sums.
+ * @param column_bounds The chunk column bounds (a single cell, the last bound is the chunk size in the x-axis).
+ * @param row_bounds The chunk row bounds (a single cell, the last bound is the chunk size in the y-axis).
+ * @param art Output string representation of the converted chunks.
  *
  * @throws error_code An exception is thrown if the alphabet length is invalid.
  */
-std::string CC_Simple::convert(Matrix<Chunk>* chunks) {
+void CC_Simple::convertSums(Matrix<unsigned long>* sums, const std::vector<msize_t>&, const std::vector<msize_t>& row_bounds, std::string& art) {
 
     // find the interval of the alphabet
     size_t alphabet_len = _alphabet.length();
@@ -46,40 +49,17 @@ std::string CC_Simple::convert(Matrix<Chunk>* chunks) {
     }
 
     uint8_t interval_len = 255 / alphabet_len;
+    unsigned long quantity = row_bounds.back() * row_bounds.back();
 
+    const msize_t line_len = sums->GetXSize() + 1;
+    art.assign(line_len * sums->GetYSize(), '\n');
 
-    // make resulting char matrix and gather chunk data
-    Matrix<char> art_result = Matrix<char>(chunks->GetXSize(), chunks->GetYSize());
-    std::shared_ptr<Matrix<uint8_t>> brightness_matrix = (*chunks)[0][0].GetData();
-
-    // iterate through chunks and generate result
-    for (msize_t y = 0; y < chunks->GetYSize(); y++) {
-        for (msize_t x = 0; x < chunks->GetXSize(); x++) {
-
-            Chunk cchunk = (*chunks)[y][x];
-
-            unsigned long sum = 0;
-            unsigned long quantity = (cchunk.GetYEnd() - cchunk.GetYStart()) * (cchunk.GetYEnd() - cchunk.GetYStart());
-
-            for (msize_t cy = cchunk.GetYStart(); cy < cchunk.GetYEnd(); cy++) {
-                for (msize_t cx = cchunk.GetXStart(); cx < cchunk.GetXEnd(); cx++) {
-                    sum += (*brightness_matrix)[cy][cx];
-                }
-            }
-
-            art_result[y][x] = _alphabet[get_char_index(interval_len, sum / quantity)];
+    // convert to final string, every line is written straight into its place
+    ParallelTiles(sums->GetYSize(), _threads, [&](msize_t y) {
+        const unsigned long* sums_row = (*sums)[y].data();
+        char* line = &art[y * line_len];
+        for (msize_t x = 0; x < sums->GetXSize(); x++) {
+            line[x] = _alphabet[get_char_index(interval_len, sums_row[x] / quantity)];
         }
-    }
-
-    std::string result = "";
-
-    // convert to final string
-    for (msize_t y = 0; y < art_result.GetYSize(); y++) {
-        for (msize_t x = 0; x < art_result.GetXSize(); x++) {
-            result.push_back(art_result[y][x]);
-        }
-        result += '\n';
-    }
-
-    return result;
+    });
 }
@@ -0,0 +1,46 @@
+#include <aac.h>
+
+/**
+ * @file aac_cc_sub_cells.cpp
+ * @brief Contains the non template helpers of the AAC::CC_SubCells class.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Computes Otsu's threshold of a histogram, the level maximizing the between class variance
+ *        of the levels up to it and the levels above it.
+ *
+ * @param histogram The histogram of 256 bins.
+ * @return The threshold (levels above it belong to the bright class).
+ */
+uint8_t AAC::OtsuThreshold(const unsigned long* histogram) {
+    unsigned long total = 0;
+    double total_sum = 0;
+    for (unsigned level = 0; level < 256; level++) {
+        total += histogram[level];
+        total_sum += (double)level * histogram[level];
+    }
+
+    unsigned long dark_count = 0;
+    double dark_sum = 0, best_variance = -1;
+    uint8_t threshold = 0;
+
+    for (unsigned level = 0; level < 256; level++) {
+        dark_count += histogram[level];
+        dark_sum += (double)level * histogram[level];
+        if (0 == dark_count || total == dark_count) {
+            continue;
+        }
+
+        unsigned long bright_count = total - dark_count;
+        double mean_difference = dark_sum / dark_count - (total_sum - dark_sum) / bright_count;
+        double variance = (double)dark_count * bright_count * mean_difference * mean_difference;
+        if (variance > best_variance) {
+            best_variance = variance;
+            threshold = (uint8_t)level;
+        }
+    }
+
+    return threshold;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file aac_cc_sub_cells.tpp
+ * @brief Contains the implementation of the AAC::CC_SubCells class.
+ */
+
+using namespace AAC;
+
+template <typename GlyphSet>
+/**
+ * @brief Constructs a sub-cell converter with a fixed break point brightness.
+ *
+ * @param break_point_brightness Sub-cells brighter than this level are raised.
+ */
+CC_SubCells<GlyphSet>::CC_SubCells(uint8_t break_point_brightness) :
+    _auto_threshold(false), _threshold(break_point_brightness) {}
+
+template <typename GlyphSet>
+/**
+ * @brief Constructs a sub-cell converter choosing the break point brightness automatically.
+ *        Otsu's threshold of the sub-cell brightness histogram is used for every converted image.
+ */
+CC_SubCells<GlyphSet>::CC_SubCells() : _auto_threshold(true), _threshold(0) {}
+
+template <typename GlyphSet>
+/**
+ * @brief Gets the break point brightness used by the last conversion.
+ *
+ * @return The threshold, sub-cells brighter than it are raised.
+ */
+uint8_t CC_SubCells<GlyphSet>::GetThreshold() const {
+    return _threshold;
+}
+
+template <typename GlyphSet>
+/**
+ * @brief Gets the division of a chunk into the sub-cells of the glyph set. Pixels that do not divide
+ *        evenly are given to the sub-cell columns and rows of the lowest ranks.
+ *
+ * @param chunk_x_size The chunk size in the x-axis.
+ * @param chunk_y_size The chunk size in the y-axis.
+ * @param column_bounds Output sub-cell column bounds relative to the chunk start.
+ * @param row_bounds Output sub-cell row bounds relative to the chunk start.
+ *
+ * @throws error_code An exception is thrown if the chunk size is insufficient.
+ */
+void CC_SubCells<GlyphSet>::subcellBounds(msize_t chunk_x_size, msize_t chunk_y_size, std::vector<msize_t>& column_bounds, std::vector<msize_t>& row_bounds) const {
+
+    if (chunk_x_size < GlyphSet::COLUMNS || chunk_y_size < GlyphSet::ROWS) {
+        throw AACException(error_codes::CHUNK_SIZE_ERROR);
+    }
+
+    column_bounds.resize(GlyphSet::COLUMNS + 1);
+    row_bounds.resize(GlyphSet::ROWS + 1);
+
+    column_bounds[0] = 0;
+    for (msize_t cell_column = 0; cell_column < GlyphSet::COLUMNS; cell_column++) {
+        column_bounds[cell_column + 1] = column_bounds[cell_column] + chunk_x_size / GlyphSet::COLUMNS +
+                                         (GlyphSet::COLUMN_RANKS[cell_column] < chunk_x_size % GlyphSet::COLUMNS);
+    }
+
+    row_bounds[0] = 0;
+    for (msize_t cell_row = 0; cell_row < GlyphSet::ROWS; cell_row++) {
+        row_bounds[cell_row + 1] = row_bounds[cell_row] + chunk_y_size / GlyphSet::ROWS +
+                                   (GlyphSet::ROW_RANKS[cell_row] < chunk_y_size % GlyphSet::ROWS);
+    }
+}
+
+template <typename GlyphSet>
+/**
+ * @brief Converts the given sub-cell sums to a string of glyphs. Every sub-cell is compared with
+ *        a per sub-cell limit computed once, so no division is done per chunk (binary converters
+ *        raise sub-cells mostly covered by bright pixels). Chunks of the ignored outer rings are
+ *        single null characters. The masks and the byte length of every line are computed first,
+ *        then the lines are encoded from the glyph table; chunk rows are converted in parallel.
+ *
+ * @param sums A pointer to the matrix of sub-cell sums.
+ * @param column_bounds The sub-cell column bounds of a chunk, as given by subcellBounds.
+ * @param row_bounds The sub-cell row bounds of a chunk, as given by subcellBounds.
+ * @param art Output string representation of the converted chunks.
+ */
+void CC_SubCells<GlyphSet>::convertSums(Matrix<unsigned long>* sums, const std::vector<msize_t>& column_bounds, const std::vector<msize_t>& row_bounds, std::string& art) {
+
+    constexpr msize_t columns = GlyphSet::COLUMNS;
+    constexpr msize_t rows = GlyphSet::ROWS;
+
+    const msize_t x_chunks = sums->GetXSize() / columns;
+    const msize_t y_chunks = sums->GetYSize() / rows;
+    const msize_t margin = chunkMargin();
+    const msize_t x_first = margin, x_last = (x_chunks > 2 * margin) ? x_chunks - margin : margin;
+    const msize_t y_first = margin, y_last = (y_chunks > 2 * margin) ? y_chunks - margin : margin;
+
+    StaticMatrix<unsigned long, columns, rows> quantities;
+    for (msize_t cell_row = 0; cell_row < rows; cell_row++) {
+        for (msize_t cell_column = 0; cell_column < columns; cell_column++) {
+            quantities[cell_row][cell_column] = (unsigned long)(row_bounds[cell_row + 1] - row_bounds[cell_row]) *
+                                                (column_bounds[cell_column + 1] - column_bounds[cell_column]);
+        }
+    }
+
+    uint8_t pixel_threshold = 0;
+    const bool binary = pixelThreshold(pixel_threshold);
+
+    // automatic threshold from the histogram of sub-cell averages
+    if (_auto_threshold && !binary) {
+        unsigned long histogram[256] = {0};
+        for (msize_t y = y_first; y < y_last; y++) {
+            for (msize_t x = x_first; x < x_last; x++) {
+                for (msize_t cell_row = 0; cell_row < rows; cell_row++) {
+                    for (msize_t cell_column = 0; cell_column < columns; cell_column++) {
+                        histogram[(uint8_t)((*sums)[y * rows + cell_row][x * columns + cell_column] / quantities[cell_row][cell_column])]++;
+                    }
+                }
+            }
+        }
+        _threshold = OtsuThreshold(histogram);
+    }
+
+    // average > threshold is sum >= (threshold + 1) * quantity, more than half bright is 2 * count > quantity
+    StaticMatrix<unsigned long, columns, rows> limits;
+    for (msize_t cell_row = 0; cell_row < rows; cell_row++) {
+        for (msize_t cell_column = 0; cell_column < columns; cell_column++) {
+            const unsigned long quantity = quantities[cell_row][cell_column];
+            limits[cell_row][cell_column] = binary ? quantity / 2 : ((unsigned long)_threshold + 1) * quantity - 1;
+        }
+    }
+
+    _masks.resize(x_chunks * y_chunks);
+    _line_starts.resize(y_chunks + 1);
+    _line_starts[0] = 0;
+
+    ParallelTiles(y_chunks, _threads, [&](msize_t y) {
+        msize_t length = x_chunks + 1;
+
+        if (y >= y_first && y < y_last) {
+            uint8_t* masks = &_masks[y * x_chunks];
+            for (msize_t x = x_first; x < x_last; x++) {
+                unsigned mask = 0;
+                for (msize_t cell_row = 0; cell_row < rows; cell_row++) {
+                    const unsigned long* cell_sums = &(*sums)[y * rows + cell_row][x * columns];
+                    for (msize_t cell_column = 0; cell_column < columns; cell_column++) {
+                        mask |= (unsigned)(cell_sums[cell_column] > limits[cell_row][cell_column]) << (cell_row * columns + cell_column);
+                    }
+                }
+                masks[x] = (uint8_t)mask;
+                length += _glyphs[mask].length - 1;
+            }
+        }
+
+        _line_starts[y + 1] = length;
+    });
+
+    for (msize_t y = 0; y < y_chunks; y++) {
+        _line_starts[y + 1] += _line_starts[y];
+    }
+    art.resize(_line_starts[y_chunks]);
+
+    ParallelTiles(y_chunks, _threads, [&](msize_t y) {
+        char* line = &art[_line_starts[y]];
+        const bool inner = (y >= y_first && y < y_last);
+
+        for (msize_t x = 0; x < x_chunks; x++) {
+            if (inner && x >= x_first && x < x_last) {
+                const Glyphs::Utf8& glyph = _glyphs[_masks[y * x_chunks + x]];
+                for (uint8_t byte = 0; byte < glyph.length; byte++) {
+                    *line++ = glyph.bytes[byte];
+                }
+            }
+            else {
+                *line++ = '\0';
+            }
+        }
+        *line = '\n';
+    });
+}
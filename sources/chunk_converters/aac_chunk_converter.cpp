@@ -0,0 +1,167 @@
+#include <aac.h>
+
+/**
+ * @file aac_chunk_converter.cpp
+ * @brief Contains the default implementation of the AAC::ChunkConverter interface.
+ */
+
+using namespace AAC;
+
+#define CHUNK_TILE_COLUMNS 16
+
+/**
+ * @brief Constructs a ChunkConverter using hardware concurrency for the chunk stage.
+ */
+ChunkConverter::ChunkConverter() : _threads(0) {}
+
+/**
+ * @brief Sets the number of threads the chunk stage runs on. The result does not depend on it.
+ *
+ * @param threads Number of threads (0 means hardware concurrency).
+ */
+void ChunkConverter::SetThreads(unsigned threads) {
+    _threads = threads;
+}
+
+/**
+ * @brief Gets the division of a chunk into sub-cells as prefix bounds along each axis.
+ *        The default converter treats the whole chunk as a single cell.
+ *
+ * @param chunk_x_size The chunk size in the x-axis.
+ * @param chunk_y_size The chunk size in the y-axis.
+ * @param column_bounds Output sub-cell column bounds relative to the chunk start (first is 0, last is chunk_x_size).
+ * @param row_bounds Output sub-cell row bounds relative to the chunk start (first is 0, last is chunk_y_size).
+ */
+void ChunkConverter::subcellBounds(msize_t chunk_x_size, msize_t chunk_y_size, std::vector<msize_t>& column_bounds, std::vector<msize_t>& row_bounds) const {
+    column_bounds = {0, chunk_x_size};
+    row_bounds = {0, chunk_y_size};
+}
+
+/**
+ * @brief Gets the number of outer rings of chunks the converter ignores. Sums of those chunks are
+ *        never computed and are passed to convertSums as zeros.
+ *
+ * @return The number of ignored chunk rings, 0 for the default converter.
+ */
+msize_t ChunkConverter::chunkMargin() const {
+    return 0;
+}
+
+/**
+ * @brief Tells if the converter works on binary pixel decisions. Such converters get the number
+ *        of sub-cell pixels brighter than the threshold instead of the brightness sums.
+ *
+ * @param threshold Output threshold, set only if true is returned.
+ * @return False for the default converter.
+ */
+bool ChunkConverter::pixelThreshold(uint8_t&) const {
+    return false;
+}
+
+/**
+ * @brief Converts the chunks of the given plan to a string. Brightness of every sub-cell
+ *        is summed up by sumChunks and the sums are passed to convertSums.
+ *
+ * @param plan The chunk plan made for this converter.
+ * @param brightness_matrix A pointer to the brightness matrix the plan divides.
+ * @param transparent_chunks Optional bit per chunk, set for fully transparent (uniform) chunks
+ *                           which are summed from their first pixel.
+ * @return The resulting string representation of the converted chunks.
+ *
+ * @throws error_code An exception is thrown if the plan is empty or the brightness matrix is null.
+ */
+std::string ChunkConverter::convert(const ChunkPlan& plan, Matrix<uint8_t>* brightness_matrix, const BitMatrix* transparent_chunks) {
+
+    Matrix<unsigned long> sums(plan.GetGrid().GetXChunks() * plan.GetXCells(), plan.GetGrid().GetYChunks() * plan.GetYCells());
+    std::string art;
+
+    sumChunks(plan, brightness_matrix, transparent_chunks, sums);
+    convertSums(&sums, plan.GetColumnBounds(), plan.GetRowBounds(), art);
+
+    return art;
+}
+
+/**
+ * @brief Sums up the brightness of every sub-cell of the chunks of the given plan (binary converters
+ *        count bright pixels instead). Chunks are summed in tiles of one chunk row and up to
+ *        CHUNK_TILE_COLUMNS chunk columns run with work stealing by ParallelTiles, every tile
+ *        writes its own part of the sums. Sums of the ignored outer rings are left untouched.
+ *
+ * @param plan The chunk plan made for this converter.
+ * @param brightness_matrix A pointer to the brightness matrix the plan divides.
+ * @param transparent_chunks Optional bit per chunk, set for fully transparent (uniform) chunks
+ *                           which are summed from their first pixel.
+ * @param sums Output sub-cell sums, sized for the plan.
+ *
+ * @throws error_code An exception is thrown if the plan is empty or the brightness matrix is null.
+ */
+void ChunkConverter::sumChunks(const ChunkPlan& plan, Matrix<uint8_t>* brightness_matrix, const BitMatrix* transparent_chunks, Matrix<unsigned long>& sums) {
+
+    if (NULL == brightness_matrix) {
+        throw AACException(error_codes::INVALID_ARGUMENTS);
+    }
+
+    const ChunkGrid& grid = plan.GetGrid();
+    if (grid.IsEmpty()) {
+        throw AACException(error_codes::CHUNK_SIZE_ERROR);
+    }
+
+    const std::vector<msize_t>& column_bounds = plan.GetColumnBounds();
+    const std::vector<msize_t>& row_bounds = plan.GetRowBounds();
+    msize_t x_cells = plan.GetXCells();
+    msize_t y_cells = plan.GetYCells();
+
+    // binary converters count bright pixels on the bit packed brightness
+    uint8_t threshold = 0;
+    bool binary = pixelThreshold(threshold);
+    BitMatrix bits = binary ? BitMatrix(*brightness_matrix, threshold) : BitMatrix();
+
+    const msize_t x_first = plan.GetXMargin();
+    const msize_t x_last = grid.GetXChunks() - plan.GetXMargin();
+    const msize_t y_first = plan.GetYMargin();
+    const msize_t y_last = grid.GetYChunks() - plan.GetYMargin();
+    const msize_t tile_columns = (x_last - x_first + CHUNK_TILE_COLUMNS - 1) / CHUNK_TILE_COLUMNS;
+
+    ParallelTiles((y_last - y_first) * tile_columns, _threads, [&](msize_t tile) {
+        msize_t y = y_first + tile / tile_columns;
+        msize_t tile_start = x_first + (tile % tile_columns) * CHUNK_TILE_COLUMNS;
+        msize_t tile_end = std::min<msize_t>(tile_start + CHUNK_TILE_COLUMNS, x_last);
+
+        for (msize_t x = tile_start; x < tile_end; x++) {
+
+            const Chunk cchunk = grid.GetChunk(x, y);
+            const bool transparent = (NULL != transparent_chunks) && transparent_chunks->Get(x, y);
+
+            for (msize_t cell_row = 0; cell_row < y_cells; cell_row++) {
+                unsigned long* sums_row = &sums[y * y_cells + cell_row][x * x_cells];
+
+                for (msize_t cell_column = 0; cell_column < x_cells; cell_column++) {
+                    msize_t x_start = cchunk.GetXStart() + column_bounds[cell_column];
+                    msize_t x_end = cchunk.GetXStart() + column_bounds[cell_column + 1];
+                    msize_t y_start = cchunk.GetYStart() + row_bounds[cell_row];
+                    msize_t y_end = cchunk.GetYStart() + row_bounds[cell_row + 1];
+                    unsigned long sum = 0;
+
+                    // transparent chunks are uniform, a single pixel gives the sum
+                    if (transparent) {
+                        uint8_t value = (*brightness_matrix)[cchunk.GetYStart()][cchunk.GetXStart()];
+                        sum = (unsigned long)(binary ? (value > threshold) : value) * (x_end - x_start) * (y_end - y_start);
+                    }
+                    else if (binary) {
+                        sum = bits.Count(x_start, x_end, y_start, y_end);
+                    }
+                    else {
+                        for (msize_t cy = y_start; cy < y_end; cy++) {
+                            const uint8_t* row = (*brightness_matrix)[cy].data();
+                            for (msize_t cx = x_start; cx < x_end; cx++) {
+                                sum += row[cx];
+                            }
+                        }
+                    }
+
+                    sums_row[cell_column] = sum;
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,98 @@
+/**
+ * @file aac_glyphs.tpp
+ * @brief Contains the compile-time glyph tables of the AAC::CC_SubCells glyph sets.
+ */
+
+using namespace AAC;
+
+/**
+ * @brief Gets the sextant code point of a 2x3 sub-cell mask. The sextants block skips the
+ *        patterns of the left half, right half and full blocks, which are taken from the block elements.
+ *
+ * @param mask The sub-cell mask.
+ * @return The code point.
+ */
+constexpr uint32_t SextantGlyph(unsigned mask) {
+    switch (mask) {
+        case 0:
+            return 0x0020;
+        case 21:
+            return 0x258C;
+        case 42:
+            return 0x2590;
+        case 63:
+            return 0x2588;
+        default:
+            return 0x1FB00 + mask - 1 - (mask > 21) - (mask > 42);
+    }
+}
+
+/**
+ * @brief Gets the Braille code point of a 2x4 sub-cell mask. Dots 1-3 and 4-6 fill the upper three
+ *        rows of the left and right column, dots 7 and 8 the bottom row.
+ *
+ * @param mask The sub-cell mask.
+ * @return The code point.
+ */
+constexpr uint32_t BrailleGlyph(unsigned mask) {
+    constexpr uint8_t dot_bits[8] = {1, 8, 2, 16, 4, 32, 64, 128};
+    uint32_t dots = 0;
+    for (unsigned cell = 0; cell < 8; cell++) {
+        dots |= (mask >> cell & 1) ? dot_bits[cell] : 0;
+    }
+    return 0x2800 + dots;
+}
+
+template <size_t masks>
+/**
+ * @brief Builds the glyph table of every sub-cell mask.
+ *
+ * @param glyph Function giving the code point of a mask.
+ * @return The table.
+ */
+constexpr std::array<uint32_t, masks> MakeTable(uint32_t (*glyph)(unsigned)) {
+    std::array<uint32_t, masks> table{};
+    for (unsigned mask = 0; mask < masks; mask++) {
+        table[mask] = glyph(mask);
+    }
+    return table;
+}
+
+template <size_t masks>
+/**
+ * @brief Encodes a glyph table to UTF-8.
+ *
+ * @param table The code point of every mask.
+ * @return The encoded glyph of every mask.
+ */
+constexpr std::array<Utf8, masks> Encode(const std::array<uint32_t, masks>& table) {
+    std::array<Utf8, masks> encoded{};
+    for (size_t mask = 0; mask < masks; mask++) {
+        const uint32_t code = table[mask];
+        Utf8& glyph = encoded[mask];
+
+        if (code < 0x80) {
+            glyph.bytes[0] = (char)code;
+            glyph.length = 1;
+        }
+        else if (code < 0x800) {
+            glyph.bytes[0] = (char)(0xC0 | (code >> 6));
+            glyph.bytes[1] = (char)(0x80 | (code & 0x3F));
+            glyph.length = 2;
+        }
+        else if (code < 0x10000) {
+            glyph.bytes[0] = (char)(0xE0 | (code >> 12));
+            glyph.bytes[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+            glyph.bytes[2] = (char)(0x80 | (code & 0x3F));
+            glyph.length = 3;
+        }
+        else {
+            glyph.bytes[0] = (char)(0xF0 | (code >> 18));
+            glyph.bytes[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+            glyph.bytes[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+            glyph.bytes[3] = (char)(0x80 | (code & 0x3F));
+            glyph.length = 4;
+        }
+    }
+    return encoded;
+}
@@ -0,0 +1,372 @@
+#include <gtest/gtest.h>
+#include <aac.h>
+
+using namespace ::testing;
+using namespace AAC;
+
+TEST(BrightnessTests, EqualizeStretchesNarrowRange) {
+
+    std::vector<unsigned char> data(64 * 48);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = 100 + i % 11;
+    }
+    Image img(64, 48, 1, data.data());
+
+    BC_Simple bc;
+    BC_Equalize eq(&bc, 1);
+    std::shared_ptr<Matrix<uint8_t>> m = eq.convert(&img);
+
+    uint8_t min = 255, max = 0;
+    for (msize_t y = 0; y < m->GetYSize(); y++) {
+        for (msize_t x = 0; x < m->GetXSize(); x++) {
+            min = std::min(min, (*m)[y][x]);
+            max = std::max(max, (*m)[y][x]);
+        }
+    }
+
+    ASSERT_EQ(min, 0);
+    ASSERT_EQ(max, 255);
+
+}
+
+TEST(BrightnessTests, EqualizeThreadsIndependent) {
+
+    std::vector<unsigned char> data(97 * 53 * 3);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i * 37) % 200;
+    }
+    Image img(97, 53, 3, data.data());
+
+    BC_Simple bc;
+    BC_Equalize serial(&bc, 1);
+    BC_Equalize parallel(&bc, 4);
+    std::shared_ptr<Matrix<uint8_t>> ms = serial.convert(&img);
+    std::shared_ptr<Matrix<uint8_t>> mp = parallel.convert(&img);
+
+    for (msize_t y = 0; y < ms->GetYSize(); y++) {
+        ASSERT_EQ((*ms)[y], (*mp)[y]);
+    }
+
+}
+
+TEST(BrightnessTests, ClaheTilesThreadsIndependent) {
+
+    std::vector<unsigned char> data(120 * 90);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i % 120) + (i / 120) / 2;
+    }
+    Image img(120, 90, 1, data.data());
+
+    BC_Simple bc;
+    BC_CLAHE serial(&bc, 4, 3, 2.0, 1);
+    BC_CLAHE parallel(&bc, 4, 3, 2.0, 3);
+    std::shared_ptr<Matrix<uint8_t>> ms = serial.convert(&img);
+    std::shared_ptr<Matrix<uint8_t>> mp = parallel.convert(&img);
+
+    for (msize_t y = 0; y < ms->GetYSize(); y++) {
+        ASSERT_EQ((*ms)[y], (*mp)[y]);
+    }
+
+    BC_CLAHE aligned(&bc);
+    aligned.AlignToChunks(7, 2);
+    ASSERT_NO_THROW(aligned.convert(&img));
+
+}
+
+TEST(BrightnessTests, ClaheStretchesTilesWithinClipLimit) {
+
+    // left tiles hold a narrow ramp, right tiles are flat up to a one level checkerboard
+    std::vector<unsigned char> data(120 * 90);
+    for (size_t i = 0; i < data.size(); i++) {
+        size_t x = i % 120, y = i / 120;
+        data[i] = (x < 60) ? 100 + (x + y) % 10 : 60 + (x + y) % 2;
+    }
+    Image img(120, 90, 1, data.data());
+
+    BC_Simple bc;
+    BC_CLAHE clipped(&bc, 2, 2, 2.0, 1);
+    BC_CLAHE unclipped(&bc, 2, 2, 0, 1);
+    std::shared_ptr<Matrix<uint8_t>> mc = clipped.convert(&img);
+    std::shared_ptr<Matrix<uint8_t>> mu = unclipped.convert(&img);
+
+    // corners beyond the tile centers use a single tile mapping
+    auto range = [](Matrix<uint8_t>& m, msize_t x_start, msize_t x_end) {
+        uint8_t low = 255, high = 0;
+        for (msize_t y = 0; y < 22; y++) {
+            for (msize_t x = x_start; x < x_end; x++) {
+                low = std::min(low, m[y][x]);
+                high = std::max(high, m[y][x]);
+            }
+        }
+        return high - low;
+    };
+
+    ASSERT_GT(range(*mc, 0, 30), 2 * 9);
+    ASSERT_LT(range(*mc, 0, 30), range(*mu, 0, 30));
+    ASSERT_LE(range(*mc, 90, 120), 8);
+    ASSERT_GT(range(*mu, 90, 120), 100);
+
+}
+
+TEST(BrightnessTests, EdgesFindVerticalStep) {
+
+    std::vector<unsigned char> data(40 * 30);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i % 40 < 20) ? 0 : 255;
+    }
+    Image img(40, 30, 1, data.data());
+
+    BC_Simple bc;
+    BC_Edges serial(&bc, EdgeOperator::SOBEL, true, 1);
+    BC_Edges parallel(&bc, EdgeOperator::SOBEL, false, 4);
+    std::shared_ptr<Matrix<uint8_t>> ms = serial.convert(&img);
+    std::shared_ptr<Matrix<uint8_t>> mp = parallel.convert(&img);
+
+    for (msize_t y = 0; y < ms->GetYSize(); y++) {
+        ASSERT_EQ((*ms)[y], (*mp)[y]);
+        ASSERT_EQ((*ms)[y][5], 0);
+        ASSERT_GT((*ms)[y][20], 100);
+    }
+
+    ASSERT_NE(serial.GetDirections(), nullptr);
+    ASSERT_EQ(parallel.GetDirections(), nullptr);
+    ASSERT_EQ((*serial.GetDirections())[10][20], 0);
+
+}
+
+TEST(BrightnessTests, DitherWavefrontMatchesSerial) {
+
+    std::vector<unsigned char> data(83 * 61);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i % 83) * 3;
+    }
+    Image img(83, 61, 1, data.data());
+    BC_Simple bc;
+
+    for (DitherKernel kernel : {DitherKernel::FLOYD_STEINBERG, DitherKernel::ATKINSON, DitherKernel::SIERRA}) {
+        for (bool serpentine : {false, true}) {
+            BC_Dither serial(&bc, kernel, serpentine, 2, 1);
+            BC_Dither parallel(&bc, kernel, serpentine, 2, 4);
+            std::shared_ptr<Matrix<uint8_t>> ms = serial.convert(&img);
+            std::shared_ptr<Matrix<uint8_t>> mp = parallel.convert(&img);
+
+            for (msize_t y = 0; y < ms->GetYSize(); y++) {
+                ASSERT_EQ((*ms)[y], (*mp)[y]);
+                for (msize_t x = 0; x < ms->GetXSize(); x++) {
+                    ASSERT_TRUE(0 == (*ms)[y][x] || 255 == (*ms)[y][x]);
+                }
+            }
+        }
+    }
+
+}
+
+TEST(BrightnessTests, CompositeOverBackground) {
+
+    // left half transparent white, right half opaque black
+    std::vector<unsigned char> data(64 * 32 * 4);
+    for (size_t i = 0; i < 64 * 32; i++) {
+        bool opaque = (i % 64) >= 32;
+        data[4 * i] = data[4 * i + 1] = data[4 * i + 2] = opaque ? 0 : 255;
+        data[4 * i + 3] = opaque ? 255 : 0;
+    }
+    Image img(64, 32, 4, data.data());
+
+    BC_Composite bc(3, 3, 3, 200, 0, 2);
+    std::shared_ptr<Matrix<uint8_t>> m = bc.convert(&img);
+
+    ASSERT_EQ((*m)[3][3], 200);
+    ASSERT_EQ((*m)[3][40], 0);
+    ASSERT_TRUE(bc.IsTransparent(0, 32, 0, 32));
+    ASSERT_FALSE(bc.IsTransparent(30, 33, 0, 32));
+    ASSERT_FALSE(bc.IsTransparent(32, 64, 5, 6));
+
+    // the mask only covers the last converted region
+    bc.convertRegion(&img, {0, 16, 0, 16});
+    ASSERT_TRUE(bc.IsTransparent(0, 16, 0, 16));
+    ASSERT_FALSE(bc.IsTransparent(16, 32, 0, 16));
+    ASSERT_FALSE(bc.IsTransparent(0, 32, 0, 32));
+
+}
+
+TEST(BrightnessTests, EdgesRegionMatchesFullConversion) {
+
+    std::vector<unsigned char> data(83 * 61 * 3);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i * 53 + i / 7) % 251;
+    }
+    Image img(83, 61, 3, data.data());
+
+    BC_Simple bc;
+    BC_Edges edges(&bc, EdgeOperator::SCHARR, false, 3);
+    std::shared_ptr<Matrix<uint8_t>> full = edges.convert(&img);
+    std::shared_ptr<Matrix<uint8_t>> part = edges.convertRegion(&img, {5, 71, 9, 50});
+
+    for (msize_t y = 9; y < 50; y++) {
+        for (msize_t x = 5; x < 71; x++) {
+            ASSERT_EQ((*full)[y][x], (*part)[y][x]);
+        }
+    }
+
+}
+
+TEST(BrightnessTests, ImageWideConvertersIgnoreRegion) {
+
+    std::vector<unsigned char> data(83 * 61 * 3);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i * 53 + i / 7) % 251;
+    }
+    Image img(83, 61, 3, data.data());
+
+    // histogram and error diffusion span the whole image, so a region gives the full image values
+    BC_Simple bc;
+    BC_Equalize equalize(&bc, 1);
+    BC_Dither dither(&bc, DitherKernel::FLOYD_STEINBERG, true, 2, 1);
+
+    for (BrightnessConverter* converter : std::vector<BrightnessConverter*>{&equalize, &dither}) {
+        std::shared_ptr<Matrix<uint8_t>> full = converter->convert(&img);
+        std::shared_ptr<Matrix<uint8_t>> part = converter->convertRegion(&img, {5, 71, 9, 50});
+
+        for (msize_t y = 9; y < 50; y++) {
+            for (msize_t x = 5; x < 71; x++) {
+                ASSERT_EQ((*full)[y][x], (*part)[y][x]);
+            }
+        }
+    }
+
+}
+
+TEST(BrightnessTests, PipelineStagesFused) {
+
+    std::vector<unsigned char> data(45 * 31 * 3);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i * 29 + i / 5) % 256;
+    }
+    Image img(45, 31, 3, data.data());
+
+    BC_Composite reference(1, 2, 0.5, 0, 0, 1);
+    BC_Pipeline<Stage::Weights> weights({1, 2, 0.5});
+    BC_Pipeline<Stage::Weights, Stage::Negate, Stage::Clamp> chain({1, 2, 0.5}, {}, {10, 200});
+    std::shared_ptr<Matrix<uint8_t>> mr = reference.convert(&img);
+    std::shared_ptr<Matrix<uint8_t>> mw = weights.convert(&img);
+    std::shared_ptr<Matrix<uint8_t>> mc = chain.convert(&img);
+
+    for (msize_t y = 0; y < mr->GetYSize(); y++) {
+        ASSERT_EQ((*mr)[y], (*mw)[y]);
+        for (msize_t x = 0; x < mr->GetXSize(); x++) {
+            ASSERT_EQ((*mc)[y][x], std::max(10, std::min(200, 255 - (*mr)[y][x])));
+        }
+    }
+
+}
+
+TEST(BrightnessTests, FixedWeightsKeepGreyRamp) {
+
+    std::vector<unsigned char> data(256 * 2);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i % 256;
+    }
+    Image img(256, 2, 1, data.data());
+
+    BC_Simple simple(1, 1, 1);
+    BC_Composite composite(1, 1, 1);
+    BC_Pipeline<Stage::Weights> pipeline({1, 1, 1});
+    BC_Adjust adjust(1, 1, 1);
+    std::shared_ptr<Matrix<uint8_t>> ms = simple.convert(&img);
+
+    for (BrightnessConverter* converter : std::vector<BrightnessConverter*>{&composite, &pipeline, &adjust}) {
+        std::shared_ptr<Matrix<uint8_t>> m = converter->convert(&img);
+        for (msize_t y = 0; y < ms->GetYSize(); y++) {
+            ASSERT_EQ((*ms)[y], (*m)[y]);
+        }
+    }
+
+}
+
+TEST(BrightnessTests, AutoLevelsStretchesSampledRange) {
+
+    std::vector<unsigned char> data(90 * 70);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = 60 + (i % 90) / 2;
+    }
+    Image img(90, 70, 1, data.data());
+
+    BC_AutoLevels levels(1, 1, 1, 0, 100, 3);
+    std::shared_ptr<Matrix<uint8_t>> m = levels.convert(&img);
+
+    ASSERT_EQ((*m)[0][0], 0);
+    ASSERT_EQ((*m)[69][87], 255);
+    ASSERT_THROW(BC_AutoLevels(1, 1, 1, 50, 40), AACException);
+
+}
+
+TEST(BrightnessTests, BlurKeepsFlatAndThreadsIndependent) {
+
+    std::vector<unsigned char> flat(50 * 40, 77);
+    Image flat_img(50, 40, 1, flat.data());
+    BC_Simple bc;
+    BC_Blur box(&bc, BlurKernel::BOX, 3, 3);
+    std::shared_ptr<Matrix<uint8_t>> mf = box.convert(&flat_img);
+    ASSERT_EQ((*mf)[0][0], 77);
+    ASSERT_EQ((*mf)[39][49], 77);
+
+    std::vector<unsigned char> data(71 * 59);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i * 97) % 256;
+    }
+    Image img(71, 59, 1, data.data());
+
+    for (BlurKernel kernel : {BlurKernel::BOX, BlurKernel::GAUSSIAN}) {
+        BC_Blur serial(&bc, kernel, 2, 1);
+        BC_Blur parallel(&bc, kernel, 2, 4);
+        std::shared_ptr<Matrix<uint8_t>> ms = serial.convert(&img);
+        std::shared_ptr<Matrix<uint8_t>> mp = parallel.convert(&img);
+        for (msize_t y = 0; y < ms->GetYSize(); y++) {
+            ASSERT_EQ((*ms)[y], (*mp)[y]);
+        }
+    }
+
+}
+
+TEST(BrightnessTests, SharpenIncreasesStepContrast) {
+
+    std::vector<unsigned char> data(40 * 30);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i % 40 < 20) ? 100 : 150;
+    }
+    Image img(40, 30, 1, data.data());
+
+    BC_Simple bc;
+    BC_Sharpen sharpen(&bc, 1.5, BlurKernel::BOX, 1, 3);
+    std::shared_ptr<Matrix<uint8_t>> m = sharpen.convert(&img);
+
+    ASSERT_EQ((*m)[15][5], 100);
+    ASSERT_LT((*m)[15][19], 100);
+    ASSERT_GT((*m)[15][20], 150);
+    ASSERT_EQ((*m)[15][35], 150);
+
+    // both sides of the step overshoot by the same amount
+    ASSERT_EQ(100 - (*m)[15][19], (*m)[15][20] - 150);
+
+}
+
+TEST(BrightnessTests, AdjustMatchesPipeline) {
+
+    std::vector<unsigned char> data(37 * 23 * 4);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (i * 41 + i / 3) % 256;
+    }
+    Image img(37, 23, 4, data.data());
+
+    BC_Adjust adjust(1.2, 1, 0.8);
+    adjust.AddGamma(0.7).AddContrast(1.3).AddBrightness(-12).AddNegate();
+    BC_Pipeline<Stage::Weights, Stage::Gamma, Stage::Contrast, Stage::Brightness, Stage::Negate>
+        pipeline({1.2, 1, 0.8}, {0.7}, {1.3}, {-12}, {});
+
+    std::shared_ptr<Matrix<uint8_t>> ma = adjust.convert(&img);
+    std::shared_ptr<Matrix<uint8_t>> mp = pipeline.convert(&img);
+    for (msize_t y = 0; y < ma->GetYSize(); y++) {
+        ASSERT_EQ((*ma)[y], (*mp)[y]);
+    }
+
+}
@@ -0,0 +1,404 @@
+#include <gtest/gtest.h>
+#include <aac.h>
+
+using namespace ::testing;
+using namespace AAC;
+
+class ConverterTests : public ::testing::Test
+{
+protected:
+    std::vector<unsigned char> data;
+    Image* img;
+
+    void SetUp() override {
+        data.resize(157 * 131 * 4);
+        for (size_t i = 0; i < 157 * 131; i++) {
+            size_t x = i % 157, y = i / 157;
+            data[4 * i] = (x * 3 + y) % 256;
+            data[4 * i + 1] = (x * y) % 256;
+            data[4 * i + 2] = (y * 5) % 256;
+            data[4 * i + 3] = (x < 40) ? 0 : 255;
+        }
+        img = new Image(157, 131, 4, data.data());
+    }
+
+    void TearDown() override {
+        delete img;
+    }
+};
+
+TEST_F(ConverterTests, FusedMatchesMaterialized) {
+
+    BC_Simple bc(1.6, 1.2, 0.8, 0);
+    CC_Simple cc(" .-=*#@");
+    CC_Braile cb(90);
+
+    for (size_t chunk_size : {2, 3, 5, 8, 13}) {
+        Converter fused(&bc, &cc);
+        Converter materialized(&bc, &cc);
+        materialized.SetFusion(false);
+        ASSERT_EQ(fused.CreateArt(img, chunk_size), materialized.CreateArt(img, chunk_size));
+
+        Converter fused_braile(&bc, &cb);
+        Converter materialized_braile(&bc, &cb);
+        materialized_braile.SetFusion(false);
+        ASSERT_EQ(fused_braile.CreateArt(img, chunk_size), materialized_braile.CreateArt(img, chunk_size));
+    }
+
+}
+
+TEST_F(ConverterTests, BraileAutoThresholdSplitsModes) {
+
+    std::vector<unsigned char> grey(120 * 120);
+    for (size_t i = 0; i < grey.size(); i++) {
+        grey[i] = ((i % 120) / 10 % 2) ? 200 + i % 7 : 30 + i % 5;
+    }
+    Image bimodal(120, 120, 1, grey.data());
+
+    BC_Composite bc(1, 1, 1);
+    CC_Braile automatic;
+    Converter converter(&bc, &automatic);
+    converter.CreateArt(&bimodal, 4);
+
+    ASSERT_GE(automatic.GetThreshold(), 32);
+    ASSERT_LT(automatic.GetThreshold(), 200);
+
+}
+
+TEST_F(ConverterTests, PyramidLevelZeroMatchesImage) {
+
+    BC_Simple bc(1.6, 1.2, 0.8, 0);
+    CC_Simple cc(" .-=*#@");
+    Converter converter(&bc, &cc);
+    BrightnessPyramid pyramid(&bc, img);
+
+    ASSERT_EQ(pyramid.GetLevelsCount(), 8u);
+    ASSERT_EQ(pyramid.GetLevel(1)->GetXSize(), 78u);
+
+    // a single pixel wide chunk can only use full resolution
+    ASSERT_EQ(converter.CreateArt(&pyramid, 1), converter.CreateArt(img, 1));
+    ASSERT_EQ(converter.CreateArt(&pyramid, 8).size(), converter.CreateArt(img, 8).size());
+
+}
+
+TEST_F(ConverterTests, PyramidCoarseLevelMatchesImage) {
+
+    // uniform 8x8 blocks make every pyramid level up to 3 exact
+    std::vector<unsigned char> blocks(128 * 96);
+    for (size_t i = 0; i < blocks.size(); i++) {
+        size_t x = i % 128, y = i / 128;
+        blocks[i] = (x / 8 * 37 + y / 8 * 91) % 256;
+    }
+    Image block_img(128, 96, 1, blocks.data());
+
+    BC_Simple bc;
+    CC_Simple cc(" .-=*#@");
+    CC_Braile cb(90);
+    CC_BraileBits cbb(90);
+    BrightnessPyramid pyramid(&bc, &block_img);
+
+    // square chunks aligned to the blocks, CC_Simple reads level 3 and the Braille converters level 1
+    for (ChunkConverter* chunk_conv : std::vector<ChunkConverter*>{&cc, &cb, &cbb}) {
+        Converter converter(&bc, chunk_conv, 1.0f);
+        ASSERT_EQ(converter.CreateArt(&pyramid, 8), converter.CreateArt(&block_img, 8));
+    }
+
+}
+
+TEST_F(ConverterTests, BraileBitsFusedMatchesMaterialized) {
+
+    BC_Simple bc(1.6, 1.2, 0.8, 0);
+    CC_BraileBits cb(90);
+
+    for (size_t chunk_size : {2, 3, 5, 8, 13}) {
+        Converter fused(&bc, &cb);
+        Converter materialized(&bc, &cb);
+        materialized.SetFusion(false);
+        ASSERT_EQ(fused.CreateArt(img, chunk_size), materialized.CreateArt(img, chunk_size));
+    }
+
+    std::vector<unsigned char> values(150);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = (i % 3) ? 200 : 10;
+    }
+    Matrix<uint8_t> m(150, 1);
+    std::copy(values.begin(), values.end(), m[0].begin());
+    BitMatrix bits(m, 90);
+
+    ASSERT_EQ(bits.Count(0, 150, 0, 1), 100u);
+    ASSERT_EQ(bits.Count(62, 131, 0, 1), 46u);
+    ASSERT_FALSE(bits.Get(63, 0));
+    ASSERT_TRUE(bits.Get(64, 0));
+
+}
+
+TEST_F(ConverterTests, ChunkGridCentersChunks) {
+
+    ChunkGrid grid(103, 50, 10, 22);
+    ASSERT_EQ(grid.GetXChunks(), 10u);
+    ASSERT_EQ(grid.GetYChunks(), 2u);
+    ASSERT_EQ(grid.GetXOrigin(), 1u);
+    ASSERT_EQ(grid.GetYOrigin(), 3u);
+
+    Chunk chunk = grid.GetChunk(9, 1);
+    ASSERT_EQ(chunk.GetXStart(), 91u);
+    ASSERT_EQ(chunk.GetXEnd(), 101u);
+    ASSERT_EQ(chunk.GetYStart(), 25u);
+    ASSERT_EQ(chunk.GetYEnd(), 47u);
+
+    Region region = grid.GetRegion(1);
+    ASSERT_EQ(region.X_start_index, 11u);
+    ASSERT_EQ(region.X_end_index, 91u);
+    ASSERT_EQ(region.Y_start_index, 25u);
+    ASSERT_EQ(region.Y_end_index, 25u);
+
+    ASSERT_TRUE(ChunkGrid(5, 5, 6, 2).IsEmpty());
+    ASSERT_THROW(ChunkGrid(5, 5, 0, 2), AACException);
+
+}
+
+TEST_F(ConverterTests, ExactDimensionsMatchWholeChunks) {
+
+    // 155 x 132 splits into whole 5 x 11 chunks, so area weights reduce to plain sums
+    std::vector<unsigned char> cropped(155 * 132 * 4);
+    for (size_t y = 0; y < 131; y++) {
+        std::copy(&data[4 * 157 * y], &data[4 * 157 * y] + 4 * 155, &cropped[4 * 155 * y]);
+    }
+    std::copy(&data[0], &data[4 * 155], &cropped[4 * 155 * 131]);
+    Image whole(155, 132, 4, cropped.data());
+
+    BC_Simple bc(1.6, 1.2, 0.8, 0);
+    CC_Simple cs(" .:-=+*#%@");
+    CC_Braile cb(90);
+
+    for (bool fusion : {true, false}) {
+        Converter simple(&bc, &cs);
+        Converter braile(&bc, &cb);
+        simple.SetFusion(fusion);
+        braile.SetFusion(fusion);
+        ASSERT_EQ(simple.CreateArt(&whole, 31, 12), simple.CreateArt(&whole, 5));
+        ASSERT_EQ(braile.CreateArt(&whole, 31, 12), braile.CreateArt(&whole, 5));
+    }
+
+    Converter converter(&bc, &cs);
+    std::string art = converter.CreateArt(img, 120, 37);
+    ASSERT_EQ(art.size(), 121u * 37);
+    ASSERT_EQ(art.find('\n'), 120u);
+    ASSERT_THROW(converter.CreateArt(img, 0, 37), AACException);
+
+}
+
+TEST_F(ConverterTests, ExactDimensionsLargeChunks) {
+
+    // weighted sums of 1000 x 1000 chunks reach 255 * 2000^4 / 4 before normalisation
+    std::vector<unsigned char> grey(2000 * 2000);
+    for (size_t i = 0; i < grey.size(); i++) {
+        grey[i] = (i % 2000 < 1000) ? 200 : 100;
+    }
+    Image large(2000, 2000, 1, grey.data());
+
+    BC_Simple bc(1, 1, 1);
+    CC_Simple cs(" .:-=+*#%@");
+    Converter converter(&bc, &cs);
+    ASSERT_EQ(converter.CreateArt(&large, 2, 2), "%=\n%=\n");
+
+}
+
+TEST_F(ConverterTests, RatioSetsChunkHeightAndPlanIsReused) {
+
+    BC_Simple bc(1.6, 1.2, 0.8, 0);
+    CC_Simple cs(" .:-=+*#%@");
+    Converter converter(&bc, &cs);
+    Converter square(&bc, &cs, 0.5);
+
+    std::string art = converter.CreateArt(img, 5);
+    std::string square_art = square.CreateArt(img, 5);
+    ASSERT_EQ(std::count(art.begin(), art.end(), '\n'), 11);
+    ASSERT_EQ(std::count(square_art.begin(), square_art.end(), '\n'), 13);
+
+    const ChunkPlan& plan = square.GetPlan(157, 131, 5);
+    ASSERT_EQ(&plan, &square.GetPlan(157, 131, 5));
+    ASSERT_EQ(plan.GetGrid().GetChunkYSize(), 10u);
+    ASSERT_EQ(square.CreateArt(img, 5), square_art);
+
+    square.SetRatio(DEFAULT_FONT_RATIO);
+    ASSERT_EQ(square.CreateArt(img, 5), art);
+    ASSERT_THROW(square.SetRatio(0), AACException);
+
+}
+
+TEST_F(ConverterTests, ChunkStatsSinglePass) {
+
+    // flat left chunk, right chunk of two row stripes
+    Matrix<uint8_t> m(8, 8);
+    for (msize_t y = 0; y < 8; y++) {
+        for (msize_t x = 0; x < 8; x++) {
+            m[y][x] = (x < 4) ? 100 : ((y / 2) % 2) * 200;
+        }
+    }
+
+    ChunkStats stats(ChunkGrid(8, 8, 4, 8), &m, 3);
+    ASSERT_EQ(stats.GetXChunks(), 2u);
+    ASSERT_EQ(stats.GetMeans()[0], 100);
+    ASSERT_EQ(stats.GetVariances()[0], 0.0f);
+    ASSERT_EQ(stats.GetMins()[0], 100);
+    ASSERT_EQ(stats.GetMaxs()[0], 100);
+    ASSERT_EQ(stats.GetMeans()[1], 100);
+    ASSERT_FLOAT_EQ(stats.GetVariances()[1], 10000.0f);
+    ASSERT_EQ(stats.GetMins()[1], 0);
+    ASSERT_EQ(stats.GetMaxs()[1], 200);
+    ASSERT_NEAR(stats.GetOrientations()[1], 128, 2);
+
+    BC_Simple bc(1.6, 1.2, 0.8, 0);
+    CC_Simple cs(" .:-=+*#%@");
+    Converter converter(&bc, &cs);
+    ChunkStats image_stats = converter.CreateStats(img, 5);
+    ASSERT_EQ(image_stats.GetMeans().size(), 31u * 11);
+
+    std::shared_ptr<Matrix<uint8_t>> brightness = bc.convert(img);
+    unsigned long sum = 0;
+    for (msize_t y = 5; y < 16; y++) {
+        for (msize_t x = 1; x < 6; x++) {
+            sum += (*brightness)[y][x];
+        }
+    }
+    ASSERT_EQ(image_stats.GetMeans()[0], (sum + 27) / 55);
+
+}
+
+TEST_F(ConverterTests, TiledChunkStageMatchesSerial) {
+
+    BC_Simple bc(1.6, 1.2, 0.8, 0);
+    CC_Simple cs(" .:-=+*#%@");
+    CC_Braile cb(90);
+    CC_BraileBits cbb(90);
+
+    for (ChunkConverter* cc : std::vector<ChunkConverter*>{&cs, &cb, &cbb}) {
+        for (size_t chunk_size : {2, 3, 8}) {
+            Converter converter(&bc, cc);
+            converter.SetFusion(false);
+
+            cc->SetThreads(1);
+            std::string serial = converter.CreateArt(img, chunk_size);
+            cc->SetThreads(4);
+            ASSERT_EQ(converter.CreateArt(img, chunk_size), serial);
+        }
+    }
+
+}
+
+TEST_F(ConverterTests, ParallelExceptionsReachCaller) {
+
+    std::atomic<unsigned> finished(0);
+    ASSERT_THROW(ParallelBands(0, 8, 4, [&](unsigned band, msize_t, msize_t) {
+        if (2 == band) {
+            throw AACException(error_codes::INVALID_ARGUMENTS);
+        }
+        finished++;
+    }), AACException);
+    ASSERT_EQ(finished.load(), 3u);
+
+    ASSERT_THROW(ParallelTiles(16, 4, [](msize_t tile) {
+        if (11 == tile) {
+            throw AACException(error_codes::INVALID_ARGUMENTS);
+        }
+    }), AACException);
+
+}
+
+TEST_F(ConverterTests, ConversionPlanReusesBuffers) {
+
+    BC_Simple bc(1.6, 1.2, 0.8, 0);
+    CC_Braile cb(90);
+    Converter converter(&bc, &cb);
+    ConversionPlan plan(157, 131, Pixel_Type::RGBA, 6, &bc, &cb);
+
+    std::string art;
+    plan.Run(img, art);
+    ASSERT_EQ(art, converter.CreateArt(img, 6));
+
+    const char* buffer = art.data();
+    plan.Run(img, art);
+    ASSERT_EQ(art.data(), buffer);
+    ASSERT_EQ(art, converter.CreateArt(img, 6));
+
+    Image other(131, 157, 4, data.data());
+    ASSERT_THROW(plan.Run(&other, art), AACException);
+
+}
+
+TEST_F(ConverterTests, ChangeTrackingSumsChangedChunks) {
+
+    BC_Simple bc(1.6, 1.2, 0.8, 0);
+    CC_Simple cs(" .:-=+*#%@");
+    Converter converter(&bc, &cs);
+    ConversionPlan plan(157, 131, Pixel_Type::RGBA, 5, &bc, &cs);
+    plan.SetChangeTracking(true);
+
+    std::string art;
+    plan.Run(img, art);
+    ASSERT_EQ(plan.GetChangedChunks().Count(0, 31, 0, 11), 31u * 11);
+
+    // repaint pixel (60, 30) which belongs to chunk (11, 2)
+    std::vector<unsigned char> changed = data;
+    for (size_t c = 0; c < 3; c++) {
+        changed[4 * (30 * 157 + 60) + c] = 255 - changed[4 * (30 * 157 + 60) + c];
+    }
+    Image frame(157, 131, 4, changed.data());
+
+    plan.Run(&frame, art);
+    ASSERT_EQ(plan.GetChangedChunks().Count(0, 31, 0, 11), 1u);
+    ASSERT_TRUE(plan.GetChangedChunks().Get(11, 2));
+    ASSERT_EQ(art, converter.CreateArt(&frame, 5));
+
+    plan.Run(&frame, art);
+    ASSERT_EQ(plan.GetChangedChunks().Count(0, 31, 0, 11), 0u);
+    ASSERT_EQ(art, converter.CreateArt(&frame, 5));
+
+    // converters using image wide statistics can not reuse sums
+    BC_AutoLevels levels(1, 1, 1);
+    ConversionPlan levels_plan(157, 131, Pixel_Type::RGBA, 5, &levels, &cs);
+    ASSERT_THROW(levels_plan.SetChangeTracking(true), AACException);
+
+}
+
+TEST_F(ConverterTests, SubCellGlyphSets) {
+
+    // the generic bounds keep the former Braille distribution of the remainder pixels
+    CC_Braile cb(90);
+    std::vector<msize_t> column_bounds, row_bounds;
+    for (msize_t size = 4; size < 12; size++) {
+        cb.subcellBounds(size / 2, size, column_bounds, row_bounds);
+        msize_t row_size = size / 4, over = size % 4;
+        ASSERT_EQ(column_bounds[1], size / 4 + (size / 2 % 2 == 1));
+        ASSERT_EQ(row_bounds[1], row_size + (over > 2));
+        ASSERT_EQ(row_bounds[2], 2 * row_size + (over > 0) + (over > 2));
+        ASSERT_EQ(row_bounds[4], size);
+    }
+
+    // sextant chunks of 2x6 pixels: dark, top left, left half, full
+    Matrix<unsigned long> sums(8, 3);
+    for (msize_t y = 0; y < 3; y++) {
+        sums[y][2] = (0 == y) ? 400 : 0;
+        sums[y][4] = 400;
+        sums[y][6] = sums[y][7] = 400;
+    }
+
+    CC_Sextants sextants(100);
+    std::string art;
+    sextants.convertSums(&sums, {0, 1, 2}, {0, 2, 4, 6}, art);
+    ASSERT_EQ(art, " \U0001FB00▌█\n");
+
+    // quadrant chunks of 2x2 pixels: dark, bottom left, left half, full
+    Matrix<unsigned long> quadrant_sums(8, 2);
+    for (msize_t y = 0; y < 2; y++) {
+        quadrant_sums[y][2] = (1 == y) ? 200 : 0;
+        quadrant_sums[y][4] = 200;
+        quadrant_sums[y][6] = quadrant_sums[y][7] = 200;
+    }
+
+    CC_Quadrants quadrants(100);
+    quadrants.convertSums(&quadrant_sums, {0, 1, 2}, {0, 1, 2}, art);
+    ASSERT_EQ(art, " ▖▌█\n");
+
+}
@@ -60,3 +60,22 @@ TEST(MatrixTest, ZeroQuantityPrevention) {
     ASSERT_THROW(m[0][0], AACException);
 
 }
+
+TEST(MatrixTest, StaticMatrix) {
+
+    constexpr StaticMatrix<int, 2, 4> filled(7);
+    static_assert(filled[3][1] == 7, "cells are readable at compile time");
+    static_assert(StaticMatrix<int, 2, 4>::GetXSize() == 2 && StaticMatrix<int, 2, 4>::GetYSize() == 4, "sizes are compile-time");
+
+    StaticMatrix<unsigned long, 2, 3> m;
+    ASSERT_EQ(m[2][1], 0u);
+
+    m[1][0] = 5;
+    ASSERT_EQ(m[1][0], 5u);
+    ASSERT_EQ(&m[1][0], &m[0][0] + 2);
+
+    m.Fill(3);
+    ASSERT_EQ(m[1][0], 3u);
+    ASSERT_EQ(sizeof(m), sizeof(unsigned long) * 6);
+
+}